@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include "nst_main.h"
+
+static int failures = 0;
+
+static void expect(int condition, const char *what)
+{
+    if (!condition)
+    {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+int main(void)
+{
+    spectrogram_config_t config;
+    spectrogram_state_t state;
+
+    spectrogram_config_default(&config, 32);
+    config.channel = -1;
+    expect(!init_spectrogram_state_with_config(&state, &config), "negative channel is rejected");
+    expect(state.spectrogram == NULL, "rejected state is left zeroed");
+
+    config.channel = NST_EVENT_MAX_VALUES_COUNT;
+    expect(!init_spectrogram_state_with_config(&state, &config), "channel past the event values is rejected");
+
+    config.channel = NST_EVENT_MAX_VALUES_COUNT + 5;
+    expect(!init_spectrogram_state_with_config(&state, &config), "channel far past the event values is rejected");
+
+    // channel + channel_count past the end is clamped, not rejected
+    config.channel = NST_EVENT_MAX_VALUES_COUNT - 2;
+    config.channel_count = 3;
+    expect(init_spectrogram_state_with_config(&state, &config), "last channels are accepted");
+    expect(state.channel_count == 2, "channel_count is clamped to the event values");
+    expect(state.spectrogram != NULL, "accepted state has a spectrogram");
+    free_spectrogram_state(&state);
+
+    config.channel = 0;
+    config.channel_count = 1;
+    expect(init_spectrogram_state_with_config(&state, &config), "channel 0 is accepted");
+    free_spectrogram_state(&state);
+
+    config.mode = SPECTROGRAM_MODE_GOERTZEL;
+    expect(!init_spectrogram_state_with_config(&state, &config), "Goertzel without frequencies is rejected");
+
+    const double frequencies[] = {50.0};
+    config.goertzel_frequencies = frequencies;
+    config.goertzel_count = 1;
+    config.sample_rate = 200.0;
+    expect(init_spectrogram_state_with_config(&state, &config), "Goertzel with a frequency is accepted");
+    free_spectrogram_state(&state);
+
+    const double nyquist[] = {0.0, 100.0};
+    config.goertzel_frequencies = nyquist;
+    config.goertzel_count = 2;
+    expect(init_spectrogram_state_with_config(&state, &config), "Goertzel accepts DC and Nyquist");
+    free_spectrogram_state(&state);
+
+    const double aliased[] = {50.0, 100.5};
+    config.goertzel_frequencies = aliased;
+    expect(!init_spectrogram_state_with_config(&state, &config), "Goertzel above Nyquist is rejected");
+
+    const double negative[] = {-1.0};
+    config.goertzel_frequencies = negative;
+    config.goertzel_count = 1;
+    expect(!init_spectrogram_state_with_config(&state, &config), "negative Goertzel frequency is rejected");
+
+    config.goertzel_frequencies = frequencies;
+    config.sample_rate = 0.0;
+    expect(!init_spectrogram_state_with_config(&state, &config), "Goertzel with sample_rate 0 is rejected");
+    config.sample_rate = -200.0;
+    expect(!init_spectrogram_state_with_config(&state, &config), "Goertzel with negative sample_rate is rejected");
+    config.sample_rate = 200.0;
+
+    if (failures == 0)
+    {
+        printf("config_test: ok\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
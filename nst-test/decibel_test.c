@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include "decibel/decibel.h"
+
+#define BINS 64
+
+static int failures = 0;
+
+static void expect(int condition, const char *what)
+{
+    if (!condition)
+    {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+int main(void)
+{
+    decibel_quantizer_t quantizer;
+    expect(decibel_quantizer_init(&quantizer, -60.0, 0.0), "quantizer is created");
+    expect(!decibel_quantizer_init(&quantizer, 0.0, 0.0), "empty range is rejected");
+    decibel_quantizer_init(&quantizer, -60.0, 0.0);
+
+    // log2 of 1 is exact, so each level sits on a half step and the
+    // rounding is visible: k + 0.5 rounds up to k + 1 on every code path
+    float scale[BINS];
+    float offset[BINS];
+    nst_real_t power[BINS];
+    for (int k = 0; k < BINS; k++)
+    {
+        scale[k] = 1.0f;
+        offset[k] = k + 0.5f;
+        power[k] = 1.0;
+    }
+
+    uint8_t simd[BINS];
+    uint8_t scalar[BINS];
+    decibel_quantize_power_per_bin(&quantizer, scale, offset, power, BINS, simd);
+    quantizer.use_avx2 = 0;
+    decibel_quantize_power_per_bin(&quantizer, scale, offset, power, BINS, scalar);
+    for (int k = 0; k < BINS; k++)
+    {
+        expect(scalar[k] == k + 1, "scalar levels round half up");
+        expect(simd[k] == scalar[k], "vector levels match the scalar path");
+    }
+
+    if (failures == 0)
+    {
+        printf("decibel_test: ok\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "fft/fft.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Allowed error as a fraction of sum |x|, the bound on any bin
+#ifdef NST_SINGLE_PRECISION
+#define FFT_TOLERANCE 1e-5
+#else
+#define FFT_TOLERANCE 1e-12
+#endif
+
+#define BATCH_COUNT 3
+
+static int failures = 0;
+
+static void expect(int condition, const char *what, int n)
+{
+    if (!condition)
+    {
+        fprintf(stderr, "FAIL: %s, n = %d\n", what, n);
+        failures++;
+    }
+}
+
+// Reference DFT in double; k * j is reduced mod n so the angle stays exact
+static void naive_dft(const double *re, const double *im, int n, double *out_re, double *out_im)
+{
+    for (int k = 0; k < n; k++)
+    {
+        double sum_re = 0.0;
+        double sum_im = 0.0;
+        for (int j = 0; j < n; j++)
+        {
+            double theta = -2.0 * M_PI * (double)(((long long)k * j) % n) / n;
+            sum_re += re[j] * cos(theta) - im[j] * sin(theta);
+            sum_im += re[j] * sin(theta) + im[j] * cos(theta);
+        }
+        out_re[k] = sum_re;
+        out_im[k] = sum_im;
+    }
+}
+
+// Largest bin error against the reference, relative to sum |x|
+static double bin_error(const complex_t *X, const double *re, const double *im, int bins, double norm)
+{
+    double error = 0.0;
+    for (int k = 0; k < bins; k++)
+    {
+        error = fmax(error, hypot((double)X[k].real - re[k], (double)X[k].imag - im[k]));
+    }
+    return error / norm;
+}
+
+static void check_size(int n)
+{
+    double *re = (double *)calloc(n, sizeof(double));
+    double *im = (double *)calloc(n, sizeof(double));
+    double *ref_re = (double *)malloc(n * sizeof(double));
+    double *ref_im = (double *)malloc(n * sizeof(double));
+    complex_t *X = (complex_t *)malloc(n * sizeof(complex_t));
+
+    // Complex input; the values are exact in float so both precisions
+    // transform the same signal
+    double norm = 0.0;
+    for (int j = 0; j < n; j++)
+    {
+        re[j] = (double)(float)sin(0.7 * j + 0.3) + (j % 5) * 0.25;
+        im[j] = (double)(float)cos(1.3 * j) - 0.5;
+        norm += hypot(re[j], im[j]);
+    }
+    naive_dft(re, im, n, ref_re, ref_im);
+    for (int j = 0; j < n; j++)
+    {
+        X[j].real = (nst_real_t)re[j];
+        X[j].imag = (nst_real_t)im[j];
+    }
+    fft(X, n);
+    expect(bin_error(X, ref_re, ref_im, n, norm) < FFT_TOLERANCE, "fft matches the DFT", n);
+
+    if (n >= 2)
+    {
+        // Real input, single and batched, each batch entry a different signal
+        int bins = n / 2 + 1;
+        nst_real_t *x[BATCH_COUNT];
+        complex_t *batch[BATCH_COUNT];
+        rfft_plan_t *plan = rfft_plan_create(n);
+        expect(plan != NULL, "rfft plan is created", n);
+        for (int c = 0; c < BATCH_COUNT; c++)
+        {
+            x[c] = (nst_real_t *)malloc(n * sizeof(nst_real_t));
+            batch[c] = (complex_t *)malloc(bins * sizeof(complex_t));
+        }
+
+        for (int c = 0; c < BATCH_COUNT; c++)
+        {
+            norm = 0.0;
+            for (int j = 0; j < n; j++)
+            {
+                re[j] = (double)(float)sin((0.4 + c) * j) + c - 1;
+                im[j] = 0.0;
+                x[c][j] = (nst_real_t)re[j];
+                norm += fabs(re[j]);
+            }
+            norm = fmax(norm, 1.0);
+            naive_dft(re, im, n, ref_re, ref_im);
+
+            if (c == 0)
+            {
+                rfft(x[c], X, n);
+                expect(bin_error(X, ref_re, ref_im, bins, norm) < FFT_TOLERANCE, "rfft matches the DFT", n);
+            }
+            if (plan)
+            {
+                rfft_execute_batch(plan, (const nst_real_t *const *)x, batch, c + 1);
+                expect(bin_error(batch[c], ref_re, ref_im, bins, norm) < FFT_TOLERANCE,
+                       "rfft_execute_batch matches the DFT", n);
+            }
+        }
+
+        for (int c = 0; c < BATCH_COUNT; c++)
+        {
+            free(x[c]);
+            free(batch[c]);
+        }
+        rfft_plan_destroy(plan);
+    }
+
+    free(re);
+    free(im);
+    free(ref_re);
+    free(ref_im);
+    free(X);
+}
+
+int main(void)
+{
+    // Powers of two, including the sizes with specialized stages
+    static const int radix2_sizes[] = {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 4096};
+    // 2^a * 3^b * 5^c
+    static const int mixed_sizes[] = {3, 5, 6, 10, 12, 15, 30, 45, 60, 100, 360, 1000};
+    // Bluestein
+    static const int prime_sizes[] = {7, 11, 13, 17, 31, 97, 257, 1009};
+
+    for (size_t i = 0; i < sizeof(radix2_sizes) / sizeof(radix2_sizes[0]); i++)
+    {
+        check_size(radix2_sizes[i]);
+    }
+    for (size_t i = 0; i < sizeof(mixed_sizes) / sizeof(mixed_sizes[0]); i++)
+    {
+        check_size(mixed_sizes[i]);
+    }
+    for (size_t i = 0; i < sizeof(prime_sizes) / sizeof(prime_sizes[0]); i++)
+    {
+        check_size(prime_sizes[i]);
+    }
+
+    if (failures == 0)
+    {
+        printf("fft_test: ok (%s)\n", fft_backend_name());
+    }
+    return failures == 0 ? 0 : 1;
+}
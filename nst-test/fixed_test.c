@@ -0,0 +1,119 @@
+#include <math.h>
+#include <stdio.h>
+#include "nst_main.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static int failures = 0;
+
+static void expect(int condition, const char *what)
+{
+    if (!condition)
+    {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+// Largest difference between the fixed-point and floating-point columns of
+// an int16 test signal, as a fraction of the floating-point peak
+static double fixed_column_error(const spectrogram_config_t *config)
+{
+    spectrogram_state_t state;
+    spectrogram_fixed_state_t fixed;
+    if (!init_spectrogram_state_with_config(&state, config))
+        return INFINITY;
+    if (!init_spectrogram_fixed_state(&fixed, config))
+    {
+        free_spectrogram_state(&state);
+        return INFINITY;
+    }
+
+    int bins = config->window_size / 2;
+    nst_real_t out[512];
+    double worst = 0.0;
+    int columns = 0;
+    for (int i = 0; i < 4 * config->window_size; i++)
+    {
+        // A loud tone between bins over a quieter one; both paths see int16 units
+        double x = 20000.0 * sin(2.0 * M_PI * 20.3 * i / config->window_size) +
+                   3000.0 * sin(2.0 * M_PI * 51.0 * i / config->window_size);
+        int16_t sample = (int16_t)lrint(x);
+        nst_real_t value = sample;
+
+        int ready = algorithm_update_frame(&state, &value);
+        if (algorithm_update_q15(&fixed, sample) != ready)
+        {
+            worst = INFINITY;
+            break;
+        }
+        if (!ready)
+            continue;
+
+        spectrogram_fixed_column(&fixed, 32768, out);
+        double peak = 0.0;
+        double error = 0.0;
+        for (int k = 0; k < bins; k++)
+        {
+            peak = fmax(peak, state.spectrogram[k]);
+            error = fmax(error, fabs((double)out[k] - state.spectrogram[k]));
+        }
+        worst = fmax(worst, error / peak);
+        columns++;
+    }
+
+    free_spectrogram_fixed_state(&fixed);
+    free_spectrogram_state(&state);
+    return columns > 0 ? worst : INFINITY;
+}
+
+int main(void)
+{
+    spectrogram_config_t config;
+    spectrogram_fixed_state_t fixed;
+
+    // Magnitudes are alpha-max-plus-beta-min estimates, within 4%
+    spectrogram_config_default(&config, 256);
+    expect(fixed_column_error(&config) < 0.05, "rectangular columns match the floating-point path");
+
+    config.window = WINDOW_HANN;
+    expect(fixed_column_error(&config) < 0.05, "Hann columns match the floating-point path");
+
+    config.window = WINDOW_KAISER;
+    config.hop_size = 64;
+    expect(fixed_column_error(&config) < 0.05, "Kaiser columns with a hop size match the floating-point path");
+
+    config.window = WINDOW_BLACKMAN_HARRIS;
+    config.hop_size = 0;
+    config.power_columns = 1;
+    expect(fixed_column_error(&config) < 0.1, "power columns match the floating-point path");
+
+    // Configurations the integer path cannot reproduce are rejected
+    spectrogram_config_default(&config, 256);
+    config.mode = SPECTROGRAM_MODE_SLIDING_DFT;
+    expect(!init_spectrogram_fixed_state(&fixed, &config), "sliding DFT mode is rejected");
+    expect(fixed.plan == NULL, "rejected state is left zeroed");
+
+    spectrogram_config_default(&config, 256);
+    config.channel_count = 3;
+    expect(!init_spectrogram_fixed_state(&fixed, &config), "several axes are rejected");
+
+    spectrogram_config_default(&config, 256);
+    config.magnitude_vector = 1;
+    expect(!init_spectrogram_fixed_state(&fixed, &config), "magnitude_vector is rejected");
+
+    spectrogram_config_default(&config, 256);
+    config.average = SPECTROGRAM_AVERAGE_WELCH;
+    expect(!init_spectrogram_fixed_state(&fixed, &config), "averaging is rejected");
+
+    spectrogram_config_default(&config, 96);
+    expect(!init_spectrogram_fixed_state(&fixed, &config), "non-power-of-two window is rejected");
+
+    if (failures == 0)
+    {
+        printf("fixed_test: ok\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+#include "autogain.h"
+#include <stdlib.h>
+
+void p2_quantile_init(p2_quantile_t *estimate, double p)
+{
+    estimate->p = p;
+    estimate->count = 0;
+}
+
+static double parabolic(const p2_quantile_t *e, int i, double d)
+{
+    const double *q = e->heights;
+    const double *n = e->positions;
+    return q[i] + d / (n[i + 1] - n[i - 1]) *
+                      ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+                       (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+static double linear(const p2_quantile_t *e, int i, int d)
+{
+    const double *q = e->heights;
+    const double *n = e->positions;
+    return q[i] + d * (q[i + d] - q[i]) / (n[i + d] - n[i]);
+}
+
+void p2_quantile_add(p2_quantile_t *e, double x)
+{
+    double *q = e->heights;
+    double *n = e->positions;
+
+    if (e->count < 5)
+    {
+        // Insertion sort of the first five values
+        int i = e->count++;
+        while (i > 0 && q[i - 1] > x)
+        {
+            q[i] = q[i - 1];
+            i--;
+        }
+        q[i] = x;
+        if (e->count == 5)
+        {
+            double p = e->p;
+            for (int j = 0; j < 5; j++)
+            {
+                n[j] = j;
+            }
+            e->desired[0] = 0;
+            e->desired[1] = 2 * p;
+            e->desired[2] = 4 * p;
+            e->desired[3] = 2 + 2 * p;
+            e->desired[4] = 4;
+            e->increments[0] = 0;
+            e->increments[1] = p / 2;
+            e->increments[2] = p;
+            e->increments[3] = (1 + p) / 2;
+            e->increments[4] = 1;
+        }
+        return;
+    }
+
+    // Cell holding x, extending the extremes if needed
+    int k;
+    if (x < q[0])
+    {
+        q[0] = x;
+        k = 0;
+    }
+    else if (x >= q[4])
+    {
+        q[4] = x;
+        k = 3;
+    }
+    else
+    {
+        k = 0;
+        while (x >= q[k + 1])
+        {
+            k++;
+        }
+    }
+
+    for (int i = k + 1; i < 5; i++)
+    {
+        n[i] += 1;
+    }
+    for (int i = 0; i < 5; i++)
+    {
+        e->desired[i] += e->increments[i];
+    }
+
+    // Move the middle markers one step towards their desired positions
+    for (int i = 1; i < 4; i++)
+    {
+        double d = e->desired[i] - n[i];
+        if ((d >= 1 && n[i + 1] - n[i] > 1) || (d <= -1 && n[i - 1] - n[i] < -1))
+        {
+            int step = d > 0 ? 1 : -1;
+            double candidate = parabolic(e, i, step);
+            if (q[i - 1] < candidate && candidate < q[i + 1])
+            {
+                q[i] = candidate;
+            }
+            else
+            {
+                q[i] = linear(e, i, step);
+            }
+            n[i] += step;
+        }
+    }
+    e->count++;
+}
+
+double p2_quantile_value(const p2_quantile_t *e)
+{
+    if (e->count == 0)
+        return 0.0;
+    if (e->count >= 5)
+        return e->heights[2];
+    // The first values are kept sorted
+    int index = (int)(e->p * (e->count - 1) + 0.5);
+    return e->heights[index];
+}
+
+autogain_t *autogain_create(autogain_mode_t mode, int bins, double low_quantile, double high_quantile,
+                            double min_range_db, double initial_floor_db, double initial_ceiling_db)
+{
+    if (bins < 1 || !(0 < low_quantile && low_quantile < high_quantile && high_quantile < 1) ||
+        !(initial_floor_db < initial_ceiling_db))
+        return NULL;
+
+    autogain_t *gain = (autogain_t *)calloc(1, sizeof(autogain_t));
+    if (!gain)
+        return NULL;
+    gain->mode = mode;
+    gain->bins = bins;
+    gain->min_range_db = min_range_db > 0 ? min_range_db : 1.0;
+    gain->initial_floor_db = initial_floor_db;
+    gain->initial_ceiling_db = initial_ceiling_db;
+
+    int estimates = mode == AUTOGAIN_PER_BIN ? bins : 1;
+    gain->low = (p2_quantile_t *)malloc(estimates * sizeof(p2_quantile_t));
+    gain->high = (p2_quantile_t *)malloc(estimates * sizeof(p2_quantile_t));
+    if (mode == AUTOGAIN_PER_BIN)
+    {
+        gain->scale = (float *)malloc(bins * sizeof(float));
+        gain->offset = (float *)malloc(bins * sizeof(float));
+    }
+    if (!gain->low || !gain->high || (mode == AUTOGAIN_PER_BIN && (!gain->scale || !gain->offset)))
+    {
+        autogain_destroy(gain);
+        return NULL;
+    }
+
+    for (int i = 0; i < estimates; i++)
+    {
+        p2_quantile_init(&gain->low[i], low_quantile);
+        p2_quantile_init(&gain->high[i], high_quantile);
+    }
+    decibel_quantizer_init(&gain->quantizer, initial_floor_db, initial_ceiling_db);
+    return gain;
+}
+
+void autogain_destroy(autogain_t *gain)
+{
+    if (!gain)
+        return;
+    free(gain->low);
+    free(gain->high);
+    free(gain->scale);
+    free(gain->offset);
+    free(gain);
+}
+
+// Range from one pair of estimates, widened around its centre to
+// min_range_db
+static void estimated_range(const autogain_t *gain, const p2_quantile_t *low, const p2_quantile_t *high,
+                            double *floor_db, double *ceiling_db)
+{
+    if (low->count == 0)
+    {
+        *floor_db = gain->initial_floor_db;
+        *ceiling_db = gain->initial_ceiling_db;
+        return;
+    }
+
+    double lo = p2_quantile_value(low);
+    double hi = p2_quantile_value(high);
+    if (hi - lo < gain->min_range_db)
+    {
+        double centre = 0.5 * (lo + hi);
+        lo = centre - 0.5 * gain->min_range_db;
+        hi = centre + 0.5 * gain->min_range_db;
+    }
+    *floor_db = lo;
+    *ceiling_db = hi;
+}
+
+void autogain_quantize(autogain_t *gain, const nst_real_t *power, uint8_t *out)
+{
+    int bins = gain->bins;
+    double floor_db;
+    double ceiling_db;
+
+    if (gain->mode == AUTOGAIN_PER_BIN)
+    {
+        for (int k = 0; k < bins; k++)
+        {
+            if (power[k] > 0)
+            {
+                double db = decibel_from_power((float)power[k]);
+                p2_quantile_add(&gain->low[k], db);
+                p2_quantile_add(&gain->high[k], db);
+            }
+            estimated_range(gain, &gain->low[k], &gain->high[k], &floor_db, &ceiling_db);
+            decibel_level_coefficients(floor_db, ceiling_db, &gain->scale[k], &gain->offset[k]);
+        }
+        decibel_quantize_power_per_bin(&gain->quantizer, gain->scale, gain->offset, power, bins, out);
+        return;
+    }
+
+    for (int k = 0; k < bins; k++)
+    {
+        if (power[k] > 0)
+        {
+            double db = decibel_from_power((float)power[k]);
+            p2_quantile_add(gain->low, db);
+            p2_quantile_add(gain->high, db);
+        }
+    }
+    estimated_range(gain, gain->low, gain->high, &floor_db, &ceiling_db);
+    decibel_level_coefficients(floor_db, ceiling_db, &gain->quantizer.scale, &gain->quantizer.offset);
+    decibel_quantize_power(&gain->quantizer, power, bins, out);
+}
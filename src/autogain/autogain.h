@@ -0,0 +1,62 @@
+#ifndef AUTOGAIN_H
+#define AUTOGAIN_H
+
+#include <stdint.h>
+#include "../nst_types.h"
+#include "../decibel/decibel.h"
+
+// P-square streaming quantile estimate (Jain and Chlamtac, 1985): five
+// markers track the minimum, p / 2, p, (1 + p) / 2 and maximum quantiles
+// with O(1) work and memory per observation.
+typedef struct
+{
+    double p;
+    double heights[5];
+    double positions[5];
+    double desired[5];
+    double increments[5];
+    int count;
+} p2_quantile_t;
+
+void p2_quantile_init(p2_quantile_t *estimate, double p);
+void p2_quantile_add(p2_quantile_t *estimate, double x);
+
+// Current estimate; exact while fewer than five values have been seen.
+// Returns 0 before the first value.
+double p2_quantile_value(const p2_quantile_t *estimate);
+
+// Auto-ranging dB quantizer: the floor and ceiling follow streaming
+// quantiles of column power in dB, over the whole stream so far, either one
+// range for every bin or one per bin.
+typedef enum
+{
+    AUTOGAIN_GLOBAL,
+    AUTOGAIN_PER_BIN,
+} autogain_mode_t;
+
+typedef struct
+{
+    autogain_mode_t mode;
+    int bins;
+    double min_range_db;      // the range never gets narrower than this
+    double initial_floor_db;  // used until a range has been estimated
+    double initial_ceiling_db;
+    p2_quantile_t *low;       // floor quantile, one or per bin
+    p2_quantile_t *high;      // ceiling quantile, one or per bin
+    float *scale;             // per-bin level coefficients
+    float *offset;
+    decibel_quantizer_t quantizer; // global mode range; the code path in both modes
+} autogain_t;
+
+// low_quantile and high_quantile in (0, 1) pick the powers that map to
+// levels 0 and 255. Returns NULL on bad arguments or allocation failure.
+autogain_t *autogain_create(autogain_mode_t mode, int bins, double low_quantile, double high_quantile,
+                            double min_range_db, double initial_floor_db, double initial_ceiling_db);
+void autogain_destroy(autogain_t *gain);
+
+// Fold the column of bins power values into the estimates, then quantize it
+// with the updated range. Zero power carries no level information and is
+// not counted.
+void autogain_quantize(autogain_t *gain, const nst_real_t *power, uint8_t *out);
+
+#endif // AUTOGAIN_H
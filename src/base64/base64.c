@@ -0,0 +1,190 @@
+#include "base64.h"
+#include <stdint.h>
+#include <pthread.h>
+
+static const char encoding_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Whole groups of 3 bytes from data into out; returns the bytes consumed
+static size_t encode_scalar(const unsigned char *data, size_t length, char *out)
+{
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3)
+    {
+        uint32_t triple = ((uint32_t)data[i] << 16) | ((uint32_t)data[i + 1] << 8) | data[i + 2];
+        *out++ = encoding_table[(triple >> 18) & 0x3F];
+        *out++ = encoding_table[(triple >> 12) & 0x3F];
+        *out++ = encoding_table[(triple >> 6) & 0x3F];
+        *out++ = encoding_table[triple & 0x3F];
+    }
+    return i;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+// The SIMD paths follow Muła and Lemire, "Faster Base64 Encoding and
+// Decoding Using AVX2 Instructions" (2018). Each 32-bit lane receives 3
+// input bytes, shuffled so one multiply-high and one multiply-low move the
+// four 6-bit fields into separate bytes; a 16-entry table then adds the
+// offset from each field's value to its character.
+
+__attribute__((target("ssse3"))) static __m128i reshuffle_ssse3(__m128i in)
+{
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+__attribute__((target("ssse3"))) static __m128i translate_ssse3(__m128i in)
+{
+    const __m128i offsets = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+    // 0..25 -> 0, 26..51 -> 1, 52..61 -> 2..11, 62 -> 12, 63 -> 13
+    __m128i index = _mm_subs_epu8(in, _mm_set1_epi8(51));
+    index = _mm_sub_epi8(index, _mm_cmpgt_epi8(in, _mm_set1_epi8(25)));
+    return _mm_add_epi8(in, _mm_shuffle_epi8(offsets, index));
+}
+
+// 12 bytes in, 16 out per step; each load reads 16 bytes
+__attribute__((target("ssse3"))) static size_t encode_ssse3(const unsigned char *data, size_t length, char *out)
+{
+    size_t i = 0;
+    for (; i + 16 <= length; i += 12)
+    {
+        __m128i in = _mm_loadu_si128((const __m128i *)(data + i));
+        _mm_storeu_si128((__m128i *)out, translate_ssse3(reshuffle_ssse3(in)));
+        out += 16;
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) static __m256i reshuffle_avx2(__m256i in)
+{
+    in = _mm256_shuffle_epi8(in, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1, 10, 11, 9, 10,
+                                                 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    return _mm256_or_si256(t1, t3);
+}
+
+__attribute__((target("avx2"))) static __m256i translate_avx2(__m256i in)
+{
+    const __m256i offsets = _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0, 65, 71,
+                                             -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+    __m256i index = _mm256_subs_epu8(in, _mm256_set1_epi8(51));
+    index = _mm256_sub_epi8(index, _mm256_cmpgt_epi8(in, _mm256_set1_epi8(25)));
+    return _mm256_add_epi8(in, _mm256_shuffle_epi8(offsets, index));
+}
+
+// 24 bytes in, 32 out per step: 12 bytes into each 128-bit lane. The two
+// loads read 28 bytes.
+__attribute__((target("avx2"))) static size_t encode_avx2(const unsigned char *data, size_t length, char *out)
+{
+    size_t i = 0;
+    for (; i + 28 <= length; i += 24)
+    {
+        __m128i low = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i high = _mm_loadu_si128((const __m128i *)(data + i + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+        _mm256_storeu_si256((__m256i *)out, translate_avx2(reshuffle_avx2(in)));
+        out += 32;
+    }
+    return i;
+}
+
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+
+// 48 bytes in, 64 out per step: vld3 splits the byte triples into three
+// registers, so the fields come out with plain shifts and one 64-entry
+// table lookup
+static size_t encode_neon(const unsigned char *data, size_t length, char *out)
+{
+    const uint8_t *characters = (const uint8_t *)encoding_table;
+    uint8x16x4_t table = {{vld1q_u8(characters), vld1q_u8(characters + 16), vld1q_u8(characters + 32),
+                           vld1q_u8(characters + 48)}};
+    const uint8x16_t low6 = vdupq_n_u8(0x3F);
+    size_t i = 0;
+    for (; i + 48 <= length; i += 48)
+    {
+        uint8x16x3_t in = vld3q_u8(data + i);
+        uint8x16x4_t fields;
+        fields.val[0] = vshrq_n_u8(in.val[0], 2);
+        fields.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), low6);
+        fields.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), low6);
+        fields.val[3] = vandq_u8(in.val[2], low6);
+        for (int k = 0; k < 4; k++)
+        {
+            fields.val[k] = vqtbl4q_u8(table, fields.val[k]);
+        }
+        vst4q_u8((uint8_t *)out, fields);
+        out += 64;
+    }
+    return i;
+}
+
+#endif
+
+// Encodes the SIMD-sized bulk of the input and returns the bytes consumed
+typedef size_t (*bulk_encoder_t)(const unsigned char *data, size_t length, char *out);
+
+#if defined(__x86_64__) || defined(__i386__)
+// AVX2 leaves up to 27 bytes, of which SSSE3 takes what it can
+__attribute__((target("avx2"))) static size_t encode_avx2_ssse3(const unsigned char *data, size_t length, char *out)
+{
+    size_t i = encode_avx2(data, length, out);
+    return i + encode_ssse3(data + i, length - i, out + i / 3 * 4);
+}
+#endif
+
+static bulk_encoder_t bulk_encoder = encode_scalar;
+static pthread_once_t bulk_encoder_once = PTHREAD_ONCE_INIT;
+
+static void select_bulk_encoder(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        bulk_encoder = encode_avx2_ssse3;
+    }
+    else if (__builtin_cpu_supports("ssse3"))
+    {
+        bulk_encoder = encode_ssse3;
+    }
+#elif defined(__aarch64__)
+    bulk_encoder = encode_neon;
+#endif
+}
+
+size_t base64_encode_into(const unsigned char *data, size_t input_length, char *out)
+{
+    pthread_once(&bulk_encoder_once, select_bulk_encoder);
+
+    size_t i = bulk_encoder(data, input_length, out);
+    char *o = out + i / 3 * 4;
+
+    size_t done = encode_scalar(data + i, input_length - i, o);
+    i += done;
+    o += done / 3 * 4;
+
+    // Last one or two bytes, padded
+    size_t rest = input_length - i;
+    if (rest > 0)
+    {
+        uint32_t triple = (uint32_t)data[i] << 16;
+        if (rest == 2)
+        {
+            triple |= (uint32_t)data[i + 1] << 8;
+        }
+        *o++ = encoding_table[(triple >> 18) & 0x3F];
+        *o++ = encoding_table[(triple >> 12) & 0x3F];
+        *o++ = rest == 2 ? encoding_table[(triple >> 6) & 0x3F] : '=';
+        *o++ = '=';
+    }
+    return (size_t)(o - out);
+}
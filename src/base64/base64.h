@@ -0,0 +1,20 @@
+#ifndef BASE64_H
+#define BASE64_H
+
+#include <stddef.h>
+
+// Standard base64 (RFC 4648) with '=' padding. The bulk of the input is
+// encoded 24 bytes at a time with AVX2, 12 with SSSE3 or 48 with NEON,
+// picked at runtime on x86; the tail and other targets use a scalar loop.
+
+// Characters for input_length bytes, not counting a terminator
+static inline size_t base64_encoded_length(size_t input_length)
+{
+    return 4 * ((input_length + 2) / 3);
+}
+
+// Encode into out, which holds base64_encoded_length(input_length) bytes.
+// No terminator is written. Returns the characters written.
+size_t base64_encode_into(const unsigned char *data, size_t input_length, char *out);
+
+#endif // BASE64_H
@@ -0,0 +1,160 @@
+#include "colormap.h"
+#include <string.h>
+
+static const struct
+{
+    const char *name;
+    colormap_type_t type;
+} colormap_names[] = {
+    {"gray", COLORMAP_GRAY},
+    {"viridis", COLORMAP_VIRIDIS},
+    {"magma", COLORMAP_MAGMA},
+    {"inferno", COLORMAP_INFERNO},
+    {"turbo", COLORMAP_TURBO},
+};
+
+int colormap_type_from_name(const char *name, colormap_type_t *type)
+{
+    for (size_t i = 0; i < sizeof(colormap_names) / sizeof(colormap_names[0]); i++)
+    {
+        if (strcmp(name, colormap_names[i].name) == 0)
+        {
+            *type = colormap_names[i].type;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Polynomial coefficients per channel, lowest degree first
+#define POLY_TERMS 7
+
+static const double viridis_poly[3][POLY_TERMS] = {
+    {0.2777273272234177, 0.1050930431085774, -0.3308618287255563, -4.634230498983486, 6.228269936347081,
+     4.776384997670288, -5.435455855934631},
+    {0.005407344544966578, 1.404613529898575, 0.214847559468213, -5.799100973351585, 14.17993336680509,
+     -13.74514537774601, 4.645852612178535},
+    {0.3340998053353061, 1.384590162594685, 0.09509516302823659, -19.33244095627987, 56.69055260068105,
+     -65.35303263337234, 26.3124352495832},
+};
+
+static const double magma_poly[3][POLY_TERMS] = {
+    {-0.002136485053939582, 0.2516605407371642, 8.353717279216625, -27.66873308576866, 52.17613981234068,
+     -50.76852536473588, 18.65570506591883},
+    {-0.000749655052795221, 0.6775232436837668, -3.577719514958484, 14.26473078096533, -27.94360607168351,
+     29.04658282127291, -11.48977351997711},
+    {-0.005386127855323933, 2.494026599312351, 0.3144679030132573, -13.64921318813922, 12.94416944238394,
+     4.23415299384598, -5.601961508734096},
+};
+
+static const double inferno_poly[3][POLY_TERMS] = {
+    {0.0002189403691192265, 0.1065134194856116, 11.60249308247187, -41.70399613139459, 77.162935699427,
+     -71.31942824499214, 25.13112622477341},
+    {0.001651004631001012, 0.5639564367884091, -3.972853965665698, 17.43639888205313, -33.40235894210092,
+     32.62606426397723, -12.24266895238567},
+    {-0.01948089843709184, 3.932712388889277, -15.9423941062914, 44.35414519872813, -81.80730925738993,
+     73.20951985803202, -23.07032500287172},
+};
+
+static const double turbo_poly[3][POLY_TERMS] = {
+    {0.13572138, 4.61539260, -42.66032258, 132.13108234, -152.94239396, 59.28637943, 0.0},
+    {0.09140261, 2.19418839, 4.84296658, -14.18503333, 4.27729857, 2.82956604, 0.0},
+    {0.10667330, 12.64194608, -60.58204836, 110.36276771, -89.90310912, 27.34824973, 0.0},
+};
+
+static uint8_t poly_channel(const double *coeffs, double t)
+{
+    double value = 0.0;
+    for (int i = POLY_TERMS - 1; i >= 0; i--)
+    {
+        value = value * t + coeffs[i];
+    }
+    value = value < 0.0 ? 0.0 : (value > 1.0 ? 1.0 : value);
+    return (uint8_t)(value * 255.0 + 0.5);
+}
+
+static uint32_t pack_rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+    uint8_t bytes[4] = {r, g, b, a};
+    uint32_t rgba;
+    memcpy(&rgba, bytes, sizeof(rgba));
+    return rgba;
+}
+
+void colormap_init(colormap_t *colormap, colormap_type_t type)
+{
+    const double(*poly)[POLY_TERMS] = NULL;
+    switch (type)
+    {
+    case COLORMAP_VIRIDIS:
+        poly = viridis_poly;
+        break;
+    case COLORMAP_MAGMA:
+        poly = magma_poly;
+        break;
+    case COLORMAP_INFERNO:
+        poly = inferno_poly;
+        break;
+    case COLORMAP_TURBO:
+        poly = turbo_poly;
+        break;
+    default:
+        type = COLORMAP_GRAY;
+        break;
+    }
+
+    colormap->type = type;
+    for (int i = 0; i < 256; i++)
+    {
+        if (!poly)
+        {
+            colormap->rgba[i] = pack_rgba(i, i, i, 255);
+            continue;
+        }
+        double t = i / 255.0;
+        colormap->rgba[i] = pack_rgba(poly_channel(poly[0], t), poly_channel(poly[1], t), poly_channel(poly[2], t), 255);
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    colormap->use_avx2 = __builtin_cpu_supports("avx2");
+#else
+    colormap->use_avx2 = 0;
+#endif
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+__attribute__((target("avx2"))) static void apply_avx2(const colormap_t *colormap, const uint8_t *levels, int n,
+                                                       uint32_t *out)
+{
+    const int *table = (const int *)colormap->rgba;
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(levels + i)));
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_i32gather_epi32(table, index, 4));
+    }
+    for (; i < n; i++)
+    {
+        out[i] = colormap->rgba[levels[i]];
+    }
+}
+
+#endif
+
+void colormap_apply(const colormap_t *colormap, const uint8_t *levels, int n, uint32_t *out)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (colormap->use_avx2)
+    {
+        apply_avx2(colormap, levels, n, out);
+        return;
+    }
+#endif
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = colormap->rgba[levels[i]];
+    }
+}
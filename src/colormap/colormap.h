@@ -0,0 +1,46 @@
+#ifndef COLORMAP_H
+#define COLORMAP_H
+
+#include <stdint.h>
+
+// 256-entry colour lookup tables for 8-bit levels. Entries are RGBA bytes
+// in memory order, read as one uint32_t per pixel.
+typedef enum
+{
+    COLORMAP_GRAY,
+    COLORMAP_VIRIDIS,
+    COLORMAP_MAGMA,
+    COLORMAP_INFERNO,
+    COLORMAP_TURBO,
+} colormap_type_t;
+
+typedef struct
+{
+    colormap_type_t type;
+    uint32_t rgba[256];
+    int use_avx2;
+} colormap_t;
+
+// Parse "gray", "viridis", "magma", "inferno" or "turbo". Returns 0 for an
+// unknown name.
+int colormap_type_from_name(const char *name, colormap_type_t *type);
+
+// Fill the table. viridis, magma and inferno come from degree-6 polynomial
+// fits of the matplotlib maps and are within a few 8-bit steps of them;
+// turbo uses Google's degree-5 fit, which is darker at both ends.
+void colormap_init(colormap_t *colormap, colormap_type_t type);
+
+// out[i] = colormap->rgba[levels[i]] for n levels, as one gather per 8
+void colormap_apply(const colormap_t *colormap, const uint8_t *levels, int n, uint32_t *out);
+
+// Split a table entry into its bytes
+static inline void colormap_unpack(uint32_t rgba, uint8_t *r, uint8_t *g, uint8_t *b, uint8_t *a)
+{
+    const uint8_t *bytes = (const uint8_t *)&rgba;
+    *r = bytes[0];
+    *g = bytes[1];
+    *b = bytes[2];
+    *a = bytes[3];
+}
+
+#endif // COLORMAP_H
@@ -0,0 +1,182 @@
+#include "decibel.h"
+
+static int have_avx2(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    return 0;
+#endif
+}
+
+int decibel_quantizer_init(decibel_quantizer_t *quantizer, double floor_db, double ceiling_db)
+{
+    if (!(floor_db < ceiling_db))
+        return 0;
+
+    decibel_level_coefficients(floor_db, ceiling_db, &quantizer->scale, &quantizer->offset);
+    quantizer->use_avx2 = have_avx2();
+    return 1;
+}
+
+void decibel_level_coefficients(double floor_db, double ceiling_db, float *scale, float *offset)
+{
+    double levels_per_db = 255.0 / (ceiling_db - floor_db);
+    *scale = (float)(levels_per_db * DECIBEL_PER_OCTAVE);
+    *offset = (float)(-floor_db * levels_per_db);
+}
+
+// Zero, negative and NaN power map to level 0, infinity to 255
+static inline uint8_t quantize_scalar(float power, float scale, float offset)
+{
+    power = power > 0 ? power : 0;
+    float level = decibel_log2(power) * scale + offset;
+    level = level > 0.0f ? level : 0.0f;
+    level = level < 255.0f ? level : 255.0f;
+    return (uint8_t)(level + 0.5f);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+
+AVX2_TARGET static inline __m256 load8(const nst_real_t *x)
+{
+#ifdef NST_SINGLE_PRECISION
+    return _mm256_loadu_ps(x);
+#else
+    __m128 lo = _mm256_cvtpd_ps(_mm256_loadu_pd(x));
+    __m128 hi = _mm256_cvtpd_ps(_mm256_loadu_pd(x + 4));
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+#endif
+}
+
+// Same steps as quantize_scalar() on 8 values, rounded half up to int32
+// levels like it; level >= 0, so truncating level + 0.5 is the floor
+AVX2_TARGET static inline __m256i quantize8(__m256 power, __m256 scale, __m256 offset)
+{
+    // max returns the second operand for NaN
+    power = _mm256_max_ps(power, _mm256_setzero_ps());
+
+    __m256i bits = _mm256_castps_si256(power);
+    __m256 exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+    __m256i mantissa_bits = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                            _mm256_set1_epi32(0x3F800000));
+    __m256 t = _mm256_sub_ps(_mm256_castsi256_ps(mantissa_bits), _mm256_set1_ps(1.0f));
+    __m256 poly = _mm256_fmadd_ps(t, _mm256_set1_ps(DECIBEL_LOG2_C3), _mm256_set1_ps(DECIBEL_LOG2_C2));
+    poly = _mm256_fmadd_ps(t, poly, _mm256_set1_ps(DECIBEL_LOG2_C1));
+    __m256 log2_power = _mm256_fmadd_ps(t, poly, exponent);
+
+    __m256 level = _mm256_fmadd_ps(log2_power, scale, offset);
+    level = _mm256_min_ps(_mm256_max_ps(level, _mm256_setzero_ps()), _mm256_set1_ps(255.0f));
+    return _mm256_cvttps_epi32(_mm256_add_ps(level, _mm256_set1_ps(0.5f)));
+}
+
+// Four vectors of levels to 32 bytes in order. packus works within 128-bit
+// lanes, so the 4-byte groups come out interleaved and are permuted back.
+AVX2_TARGET static inline void store32(uint8_t *out, const __m256i *q)
+{
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    __m256i words = _mm256_packus_epi16(_mm256_packus_epi32(q[0], q[1]), _mm256_packus_epi32(q[2], q[3]));
+    _mm256_storeu_si256((__m256i *)out, _mm256_permutevar8x32_epi32(words, order));
+}
+
+AVX2_TARGET static void quantize_avx2(const decibel_quantizer_t *quantizer, const nst_real_t *x, int n,
+                                      int square, uint8_t *out)
+{
+    const __m256 scale = _mm256_set1_ps(quantizer->scale);
+    const __m256 offset = _mm256_set1_ps(quantizer->offset);
+
+    int i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i q[4];
+        for (int j = 0; j < 4; j++)
+        {
+            __m256 v = load8(x + i + 8 * j);
+            if (square)
+            {
+                v = _mm256_mul_ps(v, v);
+            }
+            q[j] = quantize8(v, scale, offset);
+        }
+        store32(out + i, q);
+    }
+    for (; i < n; i++)
+    {
+        float v = (float)x[i];
+        out[i] = quantize_scalar(square ? v * v : v, quantizer->scale, quantizer->offset);
+    }
+}
+
+AVX2_TARGET static void quantize_per_bin_avx2(const float *scale, const float *offset, const nst_real_t *power,
+                                              int n, uint8_t *out)
+{
+    int i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i q[4];
+        for (int j = 0; j < 4; j++)
+        {
+            int k = i + 8 * j;
+            q[j] = quantize8(load8(power + k), _mm256_loadu_ps(scale + k), _mm256_loadu_ps(offset + k));
+        }
+        store32(out + i, q);
+    }
+    for (; i < n; i++)
+    {
+        out[i] = quantize_scalar((float)power[i], scale[i], offset[i]);
+    }
+}
+
+#endif
+
+void decibel_quantize_power(const decibel_quantizer_t *quantizer, const nst_real_t *power, int n, uint8_t *out)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (quantizer->use_avx2)
+    {
+        quantize_avx2(quantizer, power, n, 0, out);
+        return;
+    }
+#endif
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = quantize_scalar((float)power[i], quantizer->scale, quantizer->offset);
+    }
+}
+
+void decibel_quantize_magnitude(const decibel_quantizer_t *quantizer, const nst_real_t *magnitude, int n,
+                                uint8_t *out)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (quantizer->use_avx2)
+    {
+        quantize_avx2(quantizer, magnitude, n, 1, out);
+        return;
+    }
+#endif
+    for (int i = 0; i < n; i++)
+    {
+        float m = (float)magnitude[i];
+        out[i] = quantize_scalar(m * m, quantizer->scale, quantizer->offset);
+    }
+}
+
+void decibel_quantize_power_per_bin(const decibel_quantizer_t *quantizer, const float *scale, const float *offset,
+                                    const nst_real_t *power, int n, uint8_t *out)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (quantizer->use_avx2)
+    {
+        quantize_per_bin_avx2(scale, offset, power, n, out);
+        return;
+    }
+#endif
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = quantize_scalar((float)power[i], scale[i], offset[i]);
+    }
+}
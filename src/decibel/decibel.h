@@ -0,0 +1,65 @@
+#ifndef DECIBEL_H
+#define DECIBEL_H
+
+#include <stdint.h>
+#include <string.h>
+#include "../nst_types.h"
+
+// Converts spectrogram columns to 8-bit levels on a decibel scale in one
+// pass: floor_db and below map to 0, ceiling_db and above saturate at 255.
+// log10 comes from the float exponent plus a cubic on the mantissa, good to
+// 0.003 dB, far below one level of any useful range.
+typedef struct
+{
+    float scale;  // levels per octave of power
+    float offset; // level of power 1
+    int use_avx2;
+} decibel_quantizer_t;
+
+// 10 * log10(2): dB per octave of power
+#define DECIBEL_PER_OCTAVE 3.01029996
+
+// log2(1 + t) ~ t * (C1 + t * (C2 + t * C3)) on [0, 1), max error 7.8e-4
+#define DECIBEL_LOG2_C1 1.42461197f
+#define DECIBEL_LOG2_C2 -0.58928683f
+#define DECIBEL_LOG2_C3 0.16545597f
+
+// Approximate log2 of x > 0; 0 gives -127
+static inline float decibel_log2(float x)
+{
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    float exponent = (float)((int)(bits >> 23) - 127);
+    uint32_t mantissa_bits = (bits & 0x007FFFFF) | 0x3F800000;
+    float mantissa;
+    memcpy(&mantissa, &mantissa_bits, sizeof(mantissa));
+    float t = mantissa - 1.0f;
+    return exponent + t * (DECIBEL_LOG2_C1 + t * (DECIBEL_LOG2_C2 + t * DECIBEL_LOG2_C3));
+}
+
+// Approximate 10 * log10(power) for power > 0
+static inline double decibel_from_power(float power)
+{
+    return DECIBEL_PER_OCTAVE * decibel_log2(power);
+}
+
+// dB here is 10 * log10(power), so a magnitude m sits at 20 * log10(m).
+// Returns 0 unless floor_db < ceiling_db.
+int decibel_quantizer_init(decibel_quantizer_t *quantizer, double floor_db, double ceiling_db);
+
+// level = log2(power) * scale + offset for the range [floor_db, ceiling_db]
+void decibel_level_coefficients(double floor_db, double ceiling_db, float *scale, float *offset);
+
+// Levels of n power values
+void decibel_quantize_power(const decibel_quantizer_t *quantizer, const nst_real_t *power, int n, uint8_t *out);
+
+// Levels of n magnitudes; they are squared in the same pass
+void decibel_quantize_magnitude(const decibel_quantizer_t *quantizer, const nst_real_t *magnitude, int n,
+                                uint8_t *out);
+
+// Levels of n power values, each with its own range from
+// decibel_level_coefficients(); quantizer only selects the code path
+void decibel_quantize_power_per_bin(const decibel_quantizer_t *quantizer, const float *scale, const float *offset,
+                                    const nst_real_t *power, int n, uint8_t *out);
+
+#endif // DECIBEL_H
@@ -0,0 +1,581 @@
+#include "fft.h"
+#include "fft_kernels.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static int ilog2(int n)
+{
+    int log2n = 0;
+    while ((1 << log2n) < n)
+    {
+        log2n++;
+    }
+    return log2n;
+}
+
+const fft_kernels_t *fft_kernels_select(void)
+{
+    // Cheap enough to repeat per plan, which keeps it free of shared state
+    const fft_kernels_t *kernels = fft_kernels_avx2();
+    if (!kernels)
+        kernels = fft_kernels_neon();
+    if (!kernels)
+        kernels = fft_kernels_scalar();
+    return kernels;
+}
+
+// Splits n into radices 4, 2, 3 and 5. Returns 0 if another prime factor remains.
+static int factorize(int n, int *factors, int *count)
+{
+    static const int radices[] = {4, 2, 3, 5};
+    *count = 0;
+    for (int r = 0; r < 4; r++)
+    {
+        while (n % radices[r] == 0 && n > 1)
+        {
+            if (*count == FFT_MAX_FACTORS)
+                return 0;
+            factors[(*count)++] = radices[r];
+            n /= radices[r];
+        }
+    }
+    return n == 1;
+}
+
+static fft_plan_t *plan_alloc(int n, fft_plan_kind_t kind)
+{
+    fft_plan_t *plan = (fft_plan_t *)calloc(1, sizeof(fft_plan_t));
+    if (!plan)
+        return NULL;
+    plan->n = n;
+    plan->kind = kind;
+    plan->kernels = fft_kernels_select();
+    return plan;
+}
+
+static int init_radix2(fft_plan_t *plan)
+{
+    int n = plan->n;
+    plan->log2n = ilog2(n);
+    plan->permutation = (int *)malloc(n * sizeof(int));
+    // Each radix-4 stage of sub-size m stores 3 * m twiddles; the total is below n.
+    plan->twiddles = (complex_t *)malloc(n * sizeof(complex_t));
+    if (!plan->permutation || !plan->twiddles)
+        return 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        int reversed = 0;
+        for (int b = 0; b < plan->log2n; b++)
+        {
+            reversed |= ((i >> b) & 1) << (plan->log2n - 1 - b);
+        }
+        plan->permutation[i] = reversed;
+    }
+
+    // An odd number of binary stages starts with a single radix-2 pass
+    complex_t *w = plan->twiddles;
+    for (int m = (plan->log2n & 1) ? 2 : 1; 4 * m <= n; m *= 4)
+    {
+        for (int k = 0; k < m; k++)
+        {
+            double theta = -2 * M_PI * k / (4 * m);
+            w[k].real = cos(theta);
+            w[k].imag = sin(theta);
+            w[m + k].real = cos(2 * theta);
+            w[m + k].imag = sin(2 * theta);
+            w[2 * m + k].real = cos(3 * theta);
+            w[2 * m + k].imag = sin(3 * theta);
+        }
+        w += 3 * m;
+    }
+
+    // The production window sizes have passes with the twiddles compiled in
+    if (plan->kernels->specialized_stages)
+        plan->specialized = plan->kernels->specialized_stages(n);
+    return 1;
+}
+
+static int init_mixed_radix(fft_plan_t *plan)
+{
+    int n = plan->n;
+    plan->permutation = (int *)malloc(n * sizeof(int));
+    // Pass s stores (p_s - 1) * m twiddles; the total is below n.
+    plan->twiddles = (complex_t *)malloc(n * sizeof(complex_t));
+    plan->scratch = (complex_t *)malloc(n * sizeof(complex_t));
+    if (!plan->permutation || !plan->twiddles || !plan->scratch)
+        return 0;
+
+    // The last pass splits by residue mod p_last, so x[i] lands at the
+    // position whose mixed-radix digits are those of i in reverse order.
+    for (int i = 0; i < n; i++)
+    {
+        int rem = i;
+        int stride = n;
+        int pos = 0;
+        for (int s = plan->factor_count - 1; s >= 0; s--)
+        {
+            int p = plan->factors[s];
+            stride /= p;
+            pos += (rem % p) * stride;
+            rem /= p;
+        }
+        plan->permutation[i] = pos;
+    }
+
+    complex_t *w = plan->twiddles;
+    int m = 1;
+    for (int s = 0; s < plan->factor_count; s++)
+    {
+        int p = plan->factors[s];
+        for (int k = 0; k < m; k++)
+        {
+            for (int r = 1; r < p; r++)
+            {
+                double theta = -2 * M_PI * r * k / (p * m);
+                w[k * (p - 1) + r - 1].real = cos(theta);
+                w[k * (p - 1) + r - 1].imag = sin(theta);
+            }
+        }
+        w += (p - 1) * m;
+        m *= p;
+    }
+    return 1;
+}
+
+static int init_bluestein(fft_plan_t *plan)
+{
+    int n = plan->n;
+    int m = 1;
+    while (m < 2 * n - 1)
+    {
+        m <<= 1;
+    }
+
+    plan->inner = fft_plan_create(m);
+    plan->chirp = (complex_t *)malloc(n * sizeof(complex_t));
+    plan->chirp_spectrum = (complex_t *)calloc(m, sizeof(complex_t));
+    plan->scratch = (complex_t *)malloc(m * sizeof(complex_t));
+    if (!plan->inner || !plan->chirp || !plan->chirp_spectrum || !plan->scratch)
+        return 0;
+
+    for (int k = 0; k < n; k++)
+    {
+        // Reduce k^2 mod 2n first so the angle stays accurate for large k
+        long long k2 = ((long long)k * k) % (2LL * n);
+        double theta = -M_PI * (double)k2 / n;
+        plan->chirp[k].real = cos(theta);
+        plan->chirp[k].imag = sin(theta);
+    }
+
+    // Convolution kernel conj(chirp) wrapped around the power-of-two length,
+    // pre-transformed and pre-scaled for the inverse FFT
+    complex_t *b = plan->chirp_spectrum;
+    b[0].real = plan->chirp[0].real / m;
+    b[0].imag = -plan->chirp[0].imag / m;
+    for (int k = 1; k < n; k++)
+    {
+        b[k].real = plan->chirp[k].real / m;
+        b[k].imag = -plan->chirp[k].imag / m;
+        b[m - k] = b[k];
+    }
+    fft_execute(plan->inner, b);
+    return 1;
+}
+
+fft_plan_t *fft_plan_create(int n)
+{
+    if (n < 1)
+        return NULL;
+
+    int factors[FFT_MAX_FACTORS];
+    int factor_count;
+    fft_plan_t *plan;
+    int ok;
+
+    if ((n & (n - 1)) == 0)
+    {
+        plan = plan_alloc(n, FFT_PLAN_RADIX2);
+        ok = plan && init_radix2(plan);
+    }
+    else if (factorize(n, factors, &factor_count))
+    {
+        plan = plan_alloc(n, FFT_PLAN_MIXED_RADIX);
+        if (plan)
+        {
+            plan->factor_count = factor_count;
+            memcpy(plan->factors, factors, sizeof(factors));
+        }
+        ok = plan && init_mixed_radix(plan);
+    }
+    else
+    {
+        plan = plan_alloc(n, FFT_PLAN_BLUESTEIN);
+        ok = plan && init_bluestein(plan);
+    }
+
+    if (!ok)
+    {
+        fft_plan_destroy(plan);
+        return NULL;
+    }
+    return plan;
+}
+
+void fft_plan_destroy(fft_plan_t *plan)
+{
+    if (!plan)
+        return;
+    free(plan->permutation);
+    free(plan->twiddles);
+    fft_plan_destroy(plan->inner);
+    free(plan->chirp);
+    free(plan->chirp_spectrum);
+    free(plan->scratch);
+    free(plan);
+}
+
+// Runs the butterfly passes on data that is already in plan->permutation order
+static void fft_stages(const fft_plan_t *plan, complex_t *X)
+{
+    if (plan->kind == FFT_PLAN_MIXED_RADIX)
+    {
+        fft_mixed_radix_stages(plan, X);
+        return;
+    }
+    if (plan->specialized)
+    {
+        plan->specialized(X);
+        return;
+    }
+
+    const fft_kernels_t *kernels = plan->kernels;
+    int n = plan->n;
+    int m = 1;
+    if (plan->log2n & 1)
+    {
+        kernels->radix2_first_stage(X, n);
+        m = 2;
+    }
+
+    const complex_t *w = plan->twiddles;
+    for (; 4 * m <= n; m *= 4)
+    {
+        kernels->radix4_stage(X, n, m, w);
+        w += 3 * m;
+    }
+}
+
+// Power-of-two passes over several arrays at once, one pass at a time so each
+// twiddle is loaded once for all of them
+static void fft_stages_batch(const fft_plan_t *plan, complex_t *const *X, int count)
+{
+    // Specialized passes have no per-stage twiddle loads to share
+    if (plan->kind != FFT_PLAN_RADIX2 || plan->specialized)
+    {
+        for (int c = 0; c < count; c++)
+        {
+            fft_stages(plan, X[c]);
+        }
+        return;
+    }
+
+    const fft_kernels_t *kernels = plan->kernels;
+    int n = plan->n;
+    int m = 1;
+    if (plan->log2n & 1)
+    {
+        for (int c = 0; c < count; c++)
+        {
+            kernels->radix2_first_stage(X[c], n);
+        }
+        m = 2;
+    }
+
+    const complex_t *w = plan->twiddles;
+    for (; 4 * m <= n; m *= 4)
+    {
+        kernels->radix4_stage_batch(X, count, n, m, w);
+        w += 3 * m;
+    }
+}
+
+// X = chirp * IFFT(FFT(chirp * x) * chirp_spectrum), with the inverse
+// transform done as conj(FFT(conj(.)))
+static void bluestein_execute(const fft_plan_t *plan, complex_t *X)
+{
+    int n = plan->n;
+    int m = plan->inner->n;
+    complex_t *a = plan->scratch;
+    const complex_t *chirp = plan->chirp;
+    const complex_t *b = plan->chirp_spectrum;
+
+    for (int k = 0; k < n; k++)
+    {
+        a[k].real = X[k].real * chirp[k].real - X[k].imag * chirp[k].imag;
+        a[k].imag = X[k].real * chirp[k].imag + X[k].imag * chirp[k].real;
+    }
+    memset(a + n, 0, (m - n) * sizeof(complex_t));
+
+    fft_execute(plan->inner, a);
+
+    for (int k = 0; k < m; k++)
+    {
+        nst_real_t re = a[k].real * b[k].real - a[k].imag * b[k].imag;
+        nst_real_t im = a[k].real * b[k].imag + a[k].imag * b[k].real;
+        a[k].real = re;
+        a[k].imag = -im;
+    }
+
+    fft_execute(plan->inner, a);
+
+    for (int k = 0; k < n; k++)
+    {
+        nst_real_t re = a[k].real;
+        nst_real_t im = -a[k].imag;
+        X[k].real = re * chirp[k].real - im * chirp[k].imag;
+        X[k].imag = re * chirp[k].imag + im * chirp[k].real;
+    }
+}
+
+void fft_execute(const fft_plan_t *plan, complex_t *X)
+{
+    int n = plan->n;
+    if (n <= 1)
+        return;
+
+    switch (plan->kind)
+    {
+    case FFT_PLAN_RADIX2:
+        // Bit reversal is its own inverse, so it can be applied by swapping
+        for (int i = 0; i < n; i++)
+        {
+            int j = plan->permutation[i];
+            if (i < j)
+            {
+                complex_t tmp = X[i];
+                X[i] = X[j];
+                X[j] = tmp;
+            }
+        }
+        break;
+    case FFT_PLAN_MIXED_RADIX:
+        for (int i = 0; i < n; i++)
+        {
+            plan->scratch[plan->permutation[i]] = X[i];
+        }
+        memcpy(X, plan->scratch, n * sizeof(complex_t));
+        break;
+    case FFT_PLAN_BLUESTEIN:
+        bluestein_execute(plan, X);
+        return;
+    }
+
+    fft_stages(plan, X);
+}
+
+const char *fft_backend_name(void)
+{
+    return fft_kernels_select()->name;
+}
+
+void fft(complex_t *X, int N)
+{
+    fft_plan_t *plan = fft_plan_create(N);
+    if (!plan)
+        return;
+    fft_execute(plan, X);
+    fft_plan_destroy(plan);
+}
+
+rfft_plan_t *rfft_plan_create(int n)
+{
+    if (n < 2)
+        return NULL;
+
+    rfft_plan_t *plan = (rfft_plan_t *)calloc(1, sizeof(rfft_plan_t));
+    if (!plan)
+        return NULL;
+
+    plan->n = n;
+    if (n & 1)
+    {
+        plan->full = fft_plan_create(n);
+        plan->scratch = (complex_t *)malloc(n * sizeof(complex_t));
+        if (!plan->full || !plan->scratch)
+        {
+            rfft_plan_destroy(plan);
+            return NULL;
+        }
+        return plan;
+    }
+
+    int quarter = n / 4;
+    plan->half = fft_plan_create(n / 2);
+    plan->twiddles = (complex_t *)malloc((quarter + 1) * sizeof(complex_t));
+    if (!plan->half || !plan->twiddles)
+    {
+        rfft_plan_destroy(plan);
+        return NULL;
+    }
+
+    for (int k = 0; k <= quarter; k++)
+    {
+        double theta = -2 * M_PI * k / n;
+        plan->twiddles[k].real = cos(theta);
+        plan->twiddles[k].imag = sin(theta);
+    }
+
+    return plan;
+}
+
+void rfft_plan_destroy(rfft_plan_t *plan)
+{
+    if (!plan)
+        return;
+    fft_plan_destroy(plan->half);
+    free(plan->twiddles);
+    fft_plan_destroy(plan->full);
+    free(plan->scratch);
+    free(plan);
+}
+
+// Odd sizes: full complex transform of the real input
+static void rfft_execute_full(const rfft_plan_t *plan, const nst_real_t *x, complex_t *X)
+{
+    int n = plan->n;
+    for (int i = 0; i < n; i++)
+    {
+        plan->scratch[i].real = x[i];
+        plan->scratch[i].imag = 0.0;
+    }
+    fft_execute(plan->full, plan->scratch);
+    memcpy(X, plan->scratch, (n / 2 + 1) * sizeof(complex_t));
+}
+
+// Pack z[j] = x[2j] + i*x[2j+1], straight into butterfly order when the half
+// plan has a permutation. Returns 1 if only the butterfly passes remain.
+static int rfft_pack(const rfft_plan_t *plan, const nst_real_t *x, complex_t *X)
+{
+    int half = plan->n / 2;
+    const int *permutation = plan->half->permutation;
+
+    if (permutation && half > 1)
+    {
+        for (int j = 0; j < half; j++)
+        {
+            X[permutation[j]].real = x[2 * j];
+            X[permutation[j]].imag = x[2 * j + 1];
+        }
+        return 1;
+    }
+
+    for (int j = 0; j < half; j++)
+    {
+        X[j].real = x[2 * j];
+        X[j].imag = x[2 * j + 1];
+    }
+    return 0;
+}
+
+// Split Z into the spectrum of the real sequence:
+// X[k] = E[k] + w^k * O[k], X[half - k] = conj(E[k] - w^k * O[k])
+// with E[k] = (Z[k] + conj(Z[half - k])) / 2, O[k] = (Z[k] - conj(Z[half - k])) / 2i
+static void rfft_split(const rfft_plan_t *plan, complex_t *X)
+{
+    int half = plan->n / 2;
+    const nst_real_t half_scale = 0.5;
+    complex_t z0 = X[0];
+    X[0].real = z0.real + z0.imag;
+    X[0].imag = 0.0;
+    X[half].real = z0.real - z0.imag;
+    X[half].imag = 0.0;
+
+    for (int k = 1; k <= half / 2; k++)
+    {
+        complex_t a = X[k];
+        complex_t b = X[half - k];
+        complex_t w = plan->twiddles[k];
+
+        nst_real_t even_r = half_scale * (a.real + b.real);
+        nst_real_t even_i = half_scale * (a.imag - b.imag);
+        nst_real_t odd_r = half_scale * (a.imag + b.imag);
+        nst_real_t odd_i = -half_scale * (a.real - b.real);
+
+        nst_real_t tr = w.real * odd_r - w.imag * odd_i;
+        nst_real_t ti = w.real * odd_i + w.imag * odd_r;
+
+        X[k].real = even_r + tr;
+        X[k].imag = even_i + ti;
+        X[half - k].real = even_r - tr;
+        X[half - k].imag = -(even_i - ti);
+    }
+}
+
+void rfft_execute(const rfft_plan_t *plan, const nst_real_t *x, complex_t *X)
+{
+    if (plan->full)
+    {
+        rfft_execute_full(plan, x, X);
+        return;
+    }
+
+    if (rfft_pack(plan, x, X))
+    {
+        fft_stages(plan->half, X);
+    }
+    else
+    {
+        fft_execute(plan->half, X);
+    }
+    rfft_split(plan, X);
+}
+
+void rfft_execute_batch(const rfft_plan_t *plan, const nst_real_t *const *x, complex_t *const *X, int count)
+{
+    if (plan->full)
+    {
+        for (int c = 0; c < count; c++)
+        {
+            rfft_execute_full(plan, x[c], X[c]);
+        }
+        return;
+    }
+
+    int permuted = 0;
+    for (int c = 0; c < count; c++)
+    {
+        permuted = rfft_pack(plan, x[c], X[c]);
+    }
+
+    if (permuted)
+    {
+        fft_stages_batch(plan->half, X, count);
+    }
+    else
+    {
+        for (int c = 0; c < count; c++)
+        {
+            fft_execute(plan->half, X[c]);
+        }
+    }
+
+    for (int c = 0; c < count; c++)
+    {
+        rfft_split(plan, X[c]);
+    }
+}
+
+void rfft(const nst_real_t *x, complex_t *X, int N)
+{
+    rfft_plan_t *plan = rfft_plan_create(N);
+    if (!plan)
+        return;
+    rfft_execute(plan, x, X);
+    rfft_plan_destroy(plan);
+}
@@ -0,0 +1,84 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include "../nst_types.h"
+
+typedef struct
+{
+    nst_real_t real;
+    nst_real_t imag;
+} complex_t;
+
+struct fft_kernels;
+
+#define FFT_MAX_FACTORS 32
+
+typedef enum
+{
+    FFT_PLAN_RADIX2,      // power of two: radix-4 passes with SIMD kernels
+    FFT_PLAN_MIXED_RADIX, // 2^a * 3^b * 5^c: radix-2/3/4/5 passes
+    FFT_PLAN_BLUESTEIN,   // any other size: chirp-z convolution on a power of two
+} fft_plan_kind_t;
+
+// Precomputed state for an in-place forward FFT of a fixed size.
+// Create once per window size and reuse for every transform. Plans with
+// scratch space must not be executed by two threads at the same time.
+typedef struct fft_plan
+{
+    int n;
+    fft_plan_kind_t kind;
+    int log2n;
+    int *permutation;     // input index -> position before the butterfly passes
+    complex_t *twiddles;  // per-stage twiddles, see fft_plan_create()
+    const struct fft_kernels *kernels;
+    void (*specialized)(complex_t *X); // power of two: compile-time passes, or NULL
+
+    int factor_count;     // mixed radix: radices in pass order
+    int factors[FFT_MAX_FACTORS];
+
+    struct fft_plan *inner;     // Bluestein: power-of-two convolution plan
+    complex_t *chirp;           // Bluestein: exp(-i*pi*k^2/n)
+    complex_t *chirp_spectrum;  // Bluestein: FFT of the conjugate chirp, scaled by 1/inner->n
+    complex_t *scratch;
+} fft_plan_t;
+
+// Create a plan for any size n >= 1. Returns NULL on allocation failure.
+fft_plan_t *fft_plan_create(int n);
+void fft_plan_destroy(fft_plan_t *plan);
+
+// Forward transform of X[0..plan->n) in place.
+void fft_execute(const fft_plan_t *plan, complex_t *X);
+
+// Name of the butterfly kernels picked for this CPU ("scalar", "avx2", "neon").
+const char *fft_backend_name(void);
+
+// Convenience one-shot transform; builds a temporary plan.
+void fft(complex_t *X, int N);
+
+// Real-input transform of size n. Even sizes are computed as an n / 2 complex
+// FFT of the packed even/odd samples followed by a twiddle pass that splits
+// the result; odd sizes fall back to a full complex transform.
+typedef struct
+{
+    int n;
+    fft_plan_t *half;     // complex plan of size n / 2 (even n)
+    complex_t *twiddles;  // w^k = exp(-2*pi*i*k/n) for k <= n / 4
+    fft_plan_t *full;     // complex plan of size n (odd n)
+    complex_t *scratch;
+} rfft_plan_t;
+
+// Create a plan for any size n >= 2. Returns NULL on allocation failure.
+rfft_plan_t *rfft_plan_create(int n);
+void rfft_plan_destroy(rfft_plan_t *plan);
+
+// Transform x[0..plan->n) into the non-negative frequency bins X[0..plan->n / 2].
+void rfft_execute(const rfft_plan_t *plan, const nst_real_t *x, complex_t *X);
+
+// Transform count independent inputs of the same size in one pass. The
+// butterfly passes run across all of them so each twiddle is loaded once.
+void rfft_execute_batch(const rfft_plan_t *plan, const nst_real_t *const *x, complex_t *const *X, int count);
+
+// Convenience one-shot real transform; X must hold N / 2 + 1 bins.
+void rfft(const nst_real_t *x, complex_t *X, int N);
+
+#endif // FFT_H
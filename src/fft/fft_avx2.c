@@ -0,0 +1,398 @@
+#include "fft_kernels.h"
+#include <stddef.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+
+#ifndef NST_SINGLE_PRECISION
+
+// Two interleaved complex values per register: [re0, im0, re1, im1].
+// wr and wi hold the twiddle real and imaginary parts duplicated per value.
+AVX2_TARGET static inline __m256d cmul2_split(__m256d a, __m256d wr, __m256d wi)
+{
+    __m256d a_swap = _mm256_permute_pd(a, 0x5);
+    return _mm256_fmaddsub_pd(a, wr, _mm256_mul_pd(a_swap, wi));
+}
+
+AVX2_TARGET static inline __m256d cmul2(__m256d a, __m256d w)
+{
+    return cmul2_split(a, _mm256_movedup_pd(w), _mm256_permute_pd(w, 0xF));
+}
+
+// Multiply by -i: (re, im) -> (im, -re)
+AVX2_TARGET static inline __m256d mul_neg_i2(__m256d a)
+{
+    const __m256d sign = _mm256_set_pd(-0.0, 0.0, -0.0, 0.0);
+    return _mm256_xor_pd(_mm256_permute_pd(a, 0x5), sign);
+}
+
+AVX2_TARGET static inline __m128d mul_neg_i1(__m128d a)
+{
+    const __m128d sign = _mm_set_pd(-0.0, 0.0);
+    return _mm_xor_pd(_mm_shuffle_pd(a, a, 0x1), sign);
+}
+
+AVX2_TARGET static void avx2_radix2_first_stage(complex_t *X, int n)
+{
+    double *x = (double *)X;
+    for (int i = 0; i < n; i += 2)
+    {
+        __m128d a = _mm_loadu_pd(x + 2 * i);
+        __m128d b = _mm_loadu_pd(x + 2 * i + 2);
+        _mm_storeu_pd(x + 2 * i, _mm_add_pd(a, b));
+        _mm_storeu_pd(x + 2 * i + 2, _mm_sub_pd(a, b));
+    }
+}
+
+// The first radix-4 stage has unit twiddles and one butterfly per group
+AVX2_TARGET static void avx2_radix4_unit_stage(complex_t *X, int n)
+{
+    double *x = (double *)X;
+    for (int group = 0; group < n; group += 4)
+    {
+        double *p = x + 2 * group;
+        __m128d a0 = _mm_loadu_pd(p);
+        __m128d a1 = _mm_loadu_pd(p + 2);
+        __m128d a2 = _mm_loadu_pd(p + 4);
+        __m128d a3 = _mm_loadu_pd(p + 6);
+
+        __m128d s0 = _mm_add_pd(a0, a1);
+        __m128d d0 = _mm_sub_pd(a0, a1);
+        __m128d s1 = _mm_add_pd(a2, a3);
+        __m128d d1 = mul_neg_i1(_mm_sub_pd(a2, a3));
+
+        _mm_storeu_pd(p, _mm_add_pd(s0, s1));
+        _mm_storeu_pd(p + 2, _mm_add_pd(d0, d1));
+        _mm_storeu_pd(p + 4, _mm_sub_pd(s0, s1));
+        _mm_storeu_pd(p + 6, _mm_sub_pd(d0, d1));
+    }
+}
+
+AVX2_TARGET static void avx2_radix4_stage(complex_t *X, int n, int m, const complex_t *w)
+{
+    if (m == 1)
+    {
+        avx2_radix4_unit_stage(X, n);
+        return;
+    }
+
+    // m is a power of two >= 2, so k advances two complex values at a time
+    const double *w1 = (const double *)w;
+    const double *w2 = (const double *)(w + m);
+    const double *w3 = (const double *)(w + 2 * m);
+
+    for (int group = 0; group < n; group += 4 * m)
+    {
+        double *x0 = (double *)(X + group);
+        double *x1 = x0 + 2 * m;
+        double *x2 = x1 + 2 * m;
+        double *x3 = x2 + 2 * m;
+
+        for (int k = 0; k < 2 * m; k += 4)
+        {
+            __m256d a0 = _mm256_loadu_pd(x0 + k);
+            __m256d t1 = cmul2(_mm256_loadu_pd(x1 + k), _mm256_loadu_pd(w2 + k));
+            __m256d t2 = cmul2(_mm256_loadu_pd(x2 + k), _mm256_loadu_pd(w1 + k));
+            __m256d t3 = cmul2(_mm256_loadu_pd(x3 + k), _mm256_loadu_pd(w3 + k));
+
+            __m256d s0 = _mm256_add_pd(a0, t1);
+            __m256d d0 = _mm256_sub_pd(a0, t1);
+            __m256d s1 = _mm256_add_pd(t2, t3);
+            __m256d d1 = mul_neg_i2(_mm256_sub_pd(t2, t3));
+
+            _mm256_storeu_pd(x0 + k, _mm256_add_pd(s0, s1));
+            _mm256_storeu_pd(x1 + k, _mm256_add_pd(d0, d1));
+            _mm256_storeu_pd(x2 + k, _mm256_sub_pd(s0, s1));
+            _mm256_storeu_pd(x3 + k, _mm256_sub_pd(d0, d1));
+        }
+    }
+}
+
+AVX2_TARGET static void avx2_radix4_stage_batch(complex_t *const *X, int count, int n, int m, const complex_t *w)
+{
+    if (m == 1)
+    {
+        for (int c = 0; c < count; c++)
+        {
+            avx2_radix4_unit_stage(X[c], n);
+        }
+        return;
+    }
+
+    const double *w1 = (const double *)w;
+    const double *w2 = (const double *)(w + m);
+    const double *w3 = (const double *)(w + 2 * m);
+
+    for (int group = 0; group < n; group += 4 * m)
+    {
+        for (int k = 0; k < 2 * m; k += 4)
+        {
+            // Split the twiddles once and reuse them for every array
+            __m256d v1 = _mm256_loadu_pd(w1 + k);
+            __m256d v2 = _mm256_loadu_pd(w2 + k);
+            __m256d v3 = _mm256_loadu_pd(w3 + k);
+            __m256d w1r = _mm256_movedup_pd(v1), w1i = _mm256_permute_pd(v1, 0xF);
+            __m256d w2r = _mm256_movedup_pd(v2), w2i = _mm256_permute_pd(v2, 0xF);
+            __m256d w3r = _mm256_movedup_pd(v3), w3i = _mm256_permute_pd(v3, 0xF);
+
+            for (int c = 0; c < count; c++)
+            {
+                double *x0 = (double *)(X[c] + group) + k;
+                double *x1 = x0 + 2 * m;
+                double *x2 = x1 + 2 * m;
+                double *x3 = x2 + 2 * m;
+
+                __m256d a0 = _mm256_loadu_pd(x0);
+                __m256d t1 = cmul2_split(_mm256_loadu_pd(x1), w2r, w2i);
+                __m256d t2 = cmul2_split(_mm256_loadu_pd(x2), w1r, w1i);
+                __m256d t3 = cmul2_split(_mm256_loadu_pd(x3), w3r, w3i);
+
+                __m256d s0 = _mm256_add_pd(a0, t1);
+                __m256d d0 = _mm256_sub_pd(a0, t1);
+                __m256d s1 = _mm256_add_pd(t2, t3);
+                __m256d d1 = mul_neg_i2(_mm256_sub_pd(t2, t3));
+
+                _mm256_storeu_pd(x0, _mm256_add_pd(s0, s1));
+                _mm256_storeu_pd(x1, _mm256_add_pd(d0, d1));
+                _mm256_storeu_pd(x2, _mm256_sub_pd(s0, s1));
+                _mm256_storeu_pd(x3, _mm256_sub_pd(d0, d1));
+            }
+        }
+    }
+}
+
+#define AVX2_SPECIALIZED fft_specialized_stages_avx2
+
+#else
+
+// Four interleaved complex values per register: [re0, im0, ..., re3, im3].
+// The m == 2 passes use the 128-bit halves with two values per register.
+AVX2_TARGET static inline __m256 cmul4_split(__m256 a, __m256 wr, __m256 wi)
+{
+    __m256 a_swap = _mm256_permute_ps(a, 0xB1);
+    return _mm256_fmaddsub_ps(a, wr, _mm256_mul_ps(a_swap, wi));
+}
+
+AVX2_TARGET static inline __m256 cmul4(__m256 a, __m256 w)
+{
+    return cmul4_split(a, _mm256_moveldup_ps(w), _mm256_movehdup_ps(w));
+}
+
+AVX2_TARGET static inline __m128 cmul2f(__m128 a, __m128 w)
+{
+    __m128 a_swap = _mm_permute_ps(a, 0xB1);
+    return _mm_fmaddsub_ps(a, _mm_moveldup_ps(w), _mm_mul_ps(a_swap, _mm_movehdup_ps(w)));
+}
+
+// Multiply by -i: (re, im) -> (im, -re)
+AVX2_TARGET static inline __m256 mul_neg_i4(__m256 a)
+{
+    const __m256 sign = _mm256_set_ps(-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f);
+    return _mm256_xor_ps(_mm256_permute_ps(a, 0xB1), sign);
+}
+
+AVX2_TARGET static inline __m128 mul_neg_i2f(__m128 a)
+{
+    const __m128 sign = _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    return _mm_xor_ps(_mm_permute_ps(a, 0xB1), sign);
+}
+
+AVX2_TARGET static void avx2_radix2_first_stage(complex_t *X, int n)
+{
+    float *x = (float *)X;
+    for (int i = 0; i < n; i += 2)
+    {
+        // [a, b] -> [a + b, a - b]
+        __m128 v = _mm_loadu_ps(x + 2 * i);
+        __m128 swapped = _mm_permute_ps(v, 0x4E);
+        _mm_storeu_ps(x + 2 * i, _mm_blend_ps(_mm_add_ps(v, swapped), _mm_sub_ps(swapped, v), 0xC));
+    }
+}
+
+// The first radix-4 stage has unit twiddles and one butterfly per group. The
+// four values of a group are paired as [a0, a2] and [a1, a3], then [s0, s1]
+// and [d0, d1], so each level is one add and one subtract.
+AVX2_TARGET static void avx2_radix4_unit_stage(complex_t *X, int n)
+{
+    const __m128 sign = _mm_set_ps(-0.0f, 0.0f, 0.0f, 0.0f);
+    float *x = (float *)X;
+    for (int group = 0; group < n; group += 4)
+    {
+        float *p = x + 2 * group;
+        __m128 v0 = _mm_loadu_ps(p);
+        __m128 v1 = _mm_loadu_ps(p + 4);
+
+        __m128 even = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 0, 1, 0));
+        __m128 odd = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 2, 3, 2));
+        __m128 sum = _mm_add_ps(even, odd);
+        __m128 diff = _mm_sub_ps(even, odd);
+        // -i on the upper value only
+        diff = _mm_xor_ps(_mm_permute_ps(diff, _MM_SHUFFLE(2, 3, 1, 0)), sign);
+
+        __m128 lo = _mm_shuffle_ps(sum, diff, _MM_SHUFFLE(1, 0, 1, 0));
+        __m128 hi = _mm_shuffle_ps(sum, diff, _MM_SHUFFLE(3, 2, 3, 2));
+        __m128 plus = _mm_add_ps(lo, hi);
+        __m128 minus = _mm_sub_ps(lo, hi);
+
+        _mm_storeu_ps(p, plus);
+        _mm_storeu_ps(p + 4, minus);
+    }
+}
+
+AVX2_TARGET static inline void butterfly2f(float *x0, float *x1, float *x2, float *x3,
+                                           __m128 t1, __m128 t2, __m128 t3)
+{
+    __m128 a0 = _mm_loadu_ps(x0);
+    __m128 s0 = _mm_add_ps(a0, t1);
+    __m128 d0 = _mm_sub_ps(a0, t1);
+    __m128 s1 = _mm_add_ps(t2, t3);
+    __m128 d1 = mul_neg_i2f(_mm_sub_ps(t2, t3));
+
+    _mm_storeu_ps(x0, _mm_add_ps(s0, s1));
+    _mm_storeu_ps(x1, _mm_add_ps(d0, d1));
+    _mm_storeu_ps(x2, _mm_sub_ps(s0, s1));
+    _mm_storeu_ps(x3, _mm_sub_ps(d0, d1));
+}
+
+AVX2_TARGET static inline void butterfly4f(float *x0, float *x1, float *x2, float *x3,
+                                           __m256 t1, __m256 t2, __m256 t3)
+{
+    __m256 a0 = _mm256_loadu_ps(x0);
+    __m256 s0 = _mm256_add_ps(a0, t1);
+    __m256 d0 = _mm256_sub_ps(a0, t1);
+    __m256 s1 = _mm256_add_ps(t2, t3);
+    __m256 d1 = mul_neg_i4(_mm256_sub_ps(t2, t3));
+
+    _mm256_storeu_ps(x0, _mm256_add_ps(s0, s1));
+    _mm256_storeu_ps(x1, _mm256_add_ps(d0, d1));
+    _mm256_storeu_ps(x2, _mm256_sub_ps(s0, s1));
+    _mm256_storeu_ps(x3, _mm256_sub_ps(d0, d1));
+}
+
+// m == 2 only follows a radix-2 first stage: both butterflies of a group fit
+// one 128-bit register per quarter
+AVX2_TARGET static void avx2_radix4_half_stage(complex_t *X, int n, const complex_t *w)
+{
+    const float *wf = (const float *)w;
+    __m128 w1 = _mm_loadu_ps(wf);
+    __m128 w2 = _mm_loadu_ps(wf + 4);
+    __m128 w3 = _mm_loadu_ps(wf + 8);
+
+    for (int group = 0; group < n; group += 8)
+    {
+        float *x0 = (float *)(X + group);
+        butterfly2f(x0, x0 + 4, x0 + 8, x0 + 12,
+                    cmul2f(_mm_loadu_ps(x0 + 4), w2),
+                    cmul2f(_mm_loadu_ps(x0 + 8), w1),
+                    cmul2f(_mm_loadu_ps(x0 + 12), w3));
+    }
+}
+
+AVX2_TARGET static void avx2_radix4_stage(complex_t *X, int n, int m, const complex_t *w)
+{
+    if (m == 1)
+    {
+        avx2_radix4_unit_stage(X, n);
+        return;
+    }
+    if (m == 2)
+    {
+        avx2_radix4_half_stage(X, n, w);
+        return;
+    }
+
+    // m is a power of two >= 4, so k advances four complex values at a time
+    const float *w1 = (const float *)w;
+    const float *w2 = (const float *)(w + m);
+    const float *w3 = (const float *)(w + 2 * m);
+
+    for (int group = 0; group < n; group += 4 * m)
+    {
+        float *x0 = (float *)(X + group);
+        float *x1 = x0 + 2 * m;
+        float *x2 = x1 + 2 * m;
+        float *x3 = x2 + 2 * m;
+
+        for (int k = 0; k < 2 * m; k += 8)
+        {
+            butterfly4f(x0 + k, x1 + k, x2 + k, x3 + k,
+                        cmul4(_mm256_loadu_ps(x1 + k), _mm256_loadu_ps(w2 + k)),
+                        cmul4(_mm256_loadu_ps(x2 + k), _mm256_loadu_ps(w1 + k)),
+                        cmul4(_mm256_loadu_ps(x3 + k), _mm256_loadu_ps(w3 + k)));
+        }
+    }
+}
+
+AVX2_TARGET static void avx2_radix4_stage_batch(complex_t *const *X, int count, int n, int m, const complex_t *w)
+{
+    if (m < 4)
+    {
+        for (int c = 0; c < count; c++)
+        {
+            avx2_radix4_stage(X[c], n, m, w);
+        }
+        return;
+    }
+
+    const float *w1 = (const float *)w;
+    const float *w2 = (const float *)(w + m);
+    const float *w3 = (const float *)(w + 2 * m);
+
+    for (int group = 0; group < n; group += 4 * m)
+    {
+        for (int k = 0; k < 2 * m; k += 8)
+        {
+            // Split the twiddles once and reuse them for every array
+            __m256 v1 = _mm256_loadu_ps(w1 + k);
+            __m256 v2 = _mm256_loadu_ps(w2 + k);
+            __m256 v3 = _mm256_loadu_ps(w3 + k);
+            __m256 w1r = _mm256_moveldup_ps(v1), w1i = _mm256_movehdup_ps(v1);
+            __m256 w2r = _mm256_moveldup_ps(v2), w2i = _mm256_movehdup_ps(v2);
+            __m256 w3r = _mm256_moveldup_ps(v3), w3i = _mm256_movehdup_ps(v3);
+
+            for (int c = 0; c < count; c++)
+            {
+                float *x0 = (float *)(X[c] + group) + k;
+                float *x1 = x0 + 2 * m;
+                float *x2 = x1 + 2 * m;
+                float *x3 = x2 + 2 * m;
+                butterfly4f(x0, x1, x2, x3,
+                            cmul4_split(_mm256_loadu_ps(x1), w2r, w2i),
+                            cmul4_split(_mm256_loadu_ps(x2), w1r, w1i),
+                            cmul4_split(_mm256_loadu_ps(x3), w3r, w3i));
+            }
+        }
+    }
+}
+
+// No float specializations yet; the passes above cover every size
+#define AVX2_SPECIALIZED NULL
+
+#endif
+
+static const fft_kernels_t avx2_kernels = {
+    "avx2",
+    avx2_radix2_first_stage,
+    avx2_radix4_stage,
+    avx2_radix4_stage_batch,
+    AVX2_SPECIALIZED,
+};
+
+const fft_kernels_t *fft_kernels_avx2(void)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return &avx2_kernels;
+    return NULL;
+}
+
+#else
+
+const fft_kernels_t *fft_kernels_avx2(void)
+{
+    return NULL;
+}
+
+#endif
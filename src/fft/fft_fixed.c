@@ -0,0 +1,294 @@
+#include "fft_fixed.h"
+#include <math.h>
+#include <stdlib.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Largest component magnitude allowed going into each kind of pass. A
+// radix-4 butterfly or the real split grows a component by at most
+// 1 + 3 * sqrt(2) < 8, a radix-2 butterfly by at most 2.
+#define RADIX4_LIMIT_BITS 28
+#define RADIX2_LIMIT_BITS 29
+
+static int ilog2(int n)
+{
+    int log2n = 0;
+    while ((1 << log2n) < n)
+    {
+        log2n++;
+    }
+    return log2n;
+}
+
+static complex_q15_t twiddle_q15(double theta)
+{
+    complex_q15_t w;
+    w.real = (int16_t)lround(cos(theta) * 32767.0);
+    w.imag = (int16_t)lround(sin(theta) * 32767.0);
+    return w;
+}
+
+static inline complex_q31_t cmul_q15(complex_q31_t a, complex_q15_t w)
+{
+    complex_q31_t result;
+    result.real = (int32_t)(((int64_t)a.real * w.real - (int64_t)a.imag * w.imag + (1 << 14)) >> 15);
+    result.imag = (int32_t)(((int64_t)a.real * w.imag + (int64_t)a.imag * w.real + (1 << 14)) >> 15);
+    return result;
+}
+
+// Block floating point: shift every value so the largest component lies in
+// [2^(limit_bits - 1), 2^limit_bits). Returns the right shift applied
+// (negative for a left shift), which the caller adds to its exponent.
+static int block_rescale(complex_q31_t *X, int count, int limit_bits)
+{
+    uint32_t max = 0;
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t re = X[i].real < 0 ? 0u - (uint32_t)X[i].real : (uint32_t)X[i].real;
+        uint32_t im = X[i].imag < 0 ? 0u - (uint32_t)X[i].imag : (uint32_t)X[i].imag;
+        max |= re | im;
+    }
+    if (max == 0)
+        return 0;
+
+    int shift = 0;
+    while ((max >> shift) >= (1u << limit_bits))
+    {
+        shift++;
+    }
+    while (shift <= 0 && shift > -30 && (max << -shift) < (1u << (limit_bits - 1)))
+    {
+        shift--;
+    }
+
+    if (shift > 0)
+    {
+        int64_t round = (int64_t)1 << (shift - 1);
+        for (int i = 0; i < count; i++)
+        {
+            X[i].real = (int32_t)(((int64_t)X[i].real + round) >> shift);
+            X[i].imag = (int32_t)(((int64_t)X[i].imag + round) >> shift);
+        }
+    }
+    else if (shift < 0)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            X[i].real = (int32_t)((uint32_t)X[i].real << -shift);
+            X[i].imag = (int32_t)((uint32_t)X[i].imag << -shift);
+        }
+    }
+    return shift;
+}
+
+fft_fixed_plan_t *fft_fixed_plan_create(int n)
+{
+    if (n < 1 || (n & (n - 1)) != 0)
+        return NULL;
+
+    fft_fixed_plan_t *plan = (fft_fixed_plan_t *)calloc(1, sizeof(fft_fixed_plan_t));
+    if (!plan)
+        return NULL;
+    plan->n = n;
+    plan->log2n = ilog2(n);
+    plan->permutation = (int *)malloc(n * sizeof(int));
+    plan->twiddles = (complex_q15_t *)malloc(n * sizeof(complex_q15_t));
+    if (!plan->permutation || !plan->twiddles)
+    {
+        fft_fixed_plan_destroy(plan);
+        return NULL;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        int reversed = 0;
+        for (int b = 0; b < plan->log2n; b++)
+        {
+            reversed |= ((i >> b) & 1) << (plan->log2n - 1 - b);
+        }
+        plan->permutation[i] = reversed;
+    }
+
+    complex_q15_t *w = plan->twiddles;
+    for (int m = (plan->log2n & 1) ? 2 : 1; 4 * m <= n; m *= 4)
+    {
+        for (int k = 0; k < m; k++)
+        {
+            double theta = -2 * M_PI * k / (4 * m);
+            w[k] = twiddle_q15(theta);
+            w[m + k] = twiddle_q15(2 * theta);
+            w[2 * m + k] = twiddle_q15(3 * theta);
+        }
+        w += 3 * m;
+    }
+    return plan;
+}
+
+void fft_fixed_plan_destroy(fft_fixed_plan_t *plan)
+{
+    if (!plan)
+        return;
+    free(plan->permutation);
+    free(plan->twiddles);
+    free(plan);
+}
+
+// Butterfly passes on bit-reversed data, same block order as fft_scalar.c
+static int fixed_stages(const fft_fixed_plan_t *plan, complex_q31_t *X)
+{
+    int n = plan->n;
+    int exponent = 0;
+    int m = 1;
+
+    if (plan->log2n & 1)
+    {
+        exponent += block_rescale(X, n, RADIX2_LIMIT_BITS);
+        for (int i = 0; i < n; i += 2)
+        {
+            complex_q31_t a = X[i];
+            complex_q31_t b = X[i + 1];
+            X[i].real = a.real + b.real;
+            X[i].imag = a.imag + b.imag;
+            X[i + 1].real = a.real - b.real;
+            X[i + 1].imag = a.imag - b.imag;
+        }
+        m = 2;
+    }
+
+    const complex_q15_t *w = plan->twiddles;
+    for (; 4 * m <= n; m *= 4)
+    {
+        exponent += block_rescale(X, n, RADIX4_LIMIT_BITS);
+        const complex_q15_t *w1 = w;
+        const complex_q15_t *w2 = w + m;
+        const complex_q15_t *w3 = w + 2 * m;
+
+        for (int group = 0; group < n; group += 4 * m)
+        {
+            complex_q31_t *x0 = X + group;
+            complex_q31_t *x1 = x0 + m;
+            complex_q31_t *x2 = x1 + m;
+            complex_q31_t *x3 = x2 + m;
+            for (int k = 0; k < m; k++)
+            {
+                complex_q31_t a0 = x0[k];
+                complex_q31_t t1 = cmul_q15(x1[k], w2[k]);
+                complex_q31_t t2 = cmul_q15(x2[k], w1[k]);
+                complex_q31_t t3 = cmul_q15(x3[k], w3[k]);
+
+                int32_t s0r = a0.real + t1.real, s0i = a0.imag + t1.imag;
+                int32_t d0r = a0.real - t1.real, d0i = a0.imag - t1.imag;
+                int32_t s1r = t2.real + t3.real, s1i = t2.imag + t3.imag;
+                int32_t d1r = t2.real - t3.real, d1i = t2.imag - t3.imag;
+
+                x0[k].real = s0r + s1r;
+                x0[k].imag = s0i + s1i;
+                x2[k].real = s0r - s1r;
+                x2[k].imag = s0i - s1i;
+                x1[k].real = d0r + d1i;
+                x1[k].imag = d0i - d1r;
+                x3[k].real = d0r - d1i;
+                x3[k].imag = d0i + d1r;
+            }
+        }
+        w += 3 * m;
+    }
+    return exponent;
+}
+
+int fft_fixed_execute(const fft_fixed_plan_t *plan, complex_q31_t *X)
+{
+    int n = plan->n;
+    for (int i = 0; i < n; i++)
+    {
+        int j = plan->permutation[i];
+        if (i < j)
+        {
+            complex_q31_t tmp = X[i];
+            X[i] = X[j];
+            X[j] = tmp;
+        }
+    }
+    return fixed_stages(plan, X);
+}
+
+rfft_fixed_plan_t *rfft_fixed_plan_create(int n)
+{
+    if (n < 4 || (n & (n - 1)) != 0)
+        return NULL;
+
+    rfft_fixed_plan_t *plan = (rfft_fixed_plan_t *)calloc(1, sizeof(rfft_fixed_plan_t));
+    if (!plan)
+        return NULL;
+    plan->n = n;
+    plan->half = fft_fixed_plan_create(n / 2);
+    plan->twiddles = (complex_q15_t *)malloc((n / 4 + 1) * sizeof(complex_q15_t));
+    if (!plan->half || !plan->twiddles)
+    {
+        rfft_fixed_plan_destroy(plan);
+        return NULL;
+    }
+
+    for (int k = 0; k <= n / 4; k++)
+    {
+        plan->twiddles[k] = twiddle_q15(-2 * M_PI * k / n);
+    }
+    return plan;
+}
+
+void rfft_fixed_plan_destroy(rfft_fixed_plan_t *plan)
+{
+    if (!plan)
+        return;
+    fft_fixed_plan_destroy(plan->half);
+    free(plan->twiddles);
+    free(plan);
+}
+
+// Same packing and split as rfft_execute(); the halving in E and O is folded
+// into the final shift of one bit
+int rfft_fixed_execute(const rfft_fixed_plan_t *plan, const int32_t *x, complex_q31_t *X)
+{
+    int half = plan->n / 2;
+    const int *permutation = plan->half->permutation;
+
+    for (int j = 0; j < half; j++)
+    {
+        X[permutation[j]].real = x[2 * j];
+        X[permutation[j]].imag = x[2 * j + 1];
+    }
+    int exponent = fixed_stages(plan->half, X);
+    exponent += block_rescale(X, half, RADIX4_LIMIT_BITS);
+
+    complex_q31_t z0 = X[0];
+    X[0].real = z0.real + z0.imag;
+    X[0].imag = 0;
+    X[half].real = z0.real - z0.imag;
+    X[half].imag = 0;
+
+    // 2 * E[k] = Z[k] + conj(Z[half - k]), 2 * O[k] = (Z[k] - conj(Z[half - k])) / i
+    for (int k = 1; k <= half / 2; k++)
+    {
+        complex_q31_t a = X[k];
+        complex_q31_t b = X[half - k];
+
+        complex_q31_t odd;
+        int32_t even_r = a.real + b.real;
+        int32_t even_i = a.imag - b.imag;
+        odd.real = a.imag + b.imag;
+        odd.imag = b.real - a.real;
+        complex_q31_t t = cmul_q15(odd, plan->twiddles[k]);
+
+        X[k].real = even_r + t.real;
+        X[k].imag = even_i + t.imag;
+        X[half - k].real = even_r - t.real;
+        X[half - k].imag = t.imag - even_i;
+    }
+
+    // Every output is now twice the true value except X[0] and X[half]
+    X[0].real *= 2;
+    X[half].real *= 2;
+    return exponent - 1;
+}
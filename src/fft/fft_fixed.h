@@ -0,0 +1,65 @@
+#ifndef FFT_FIXED_H
+#define FFT_FIXED_H
+
+#include <stdint.h>
+
+// Integer-only FFT for targets without a fast FPU. Data is int32 with Q15
+// twiddles and block floating point: every pass rescales the whole block to
+// keep 3 bits of headroom and adds the shift to a shared exponent, so the
+// true spectrum is X[k] * 2^exponent in input units.
+
+typedef struct
+{
+    int32_t real;
+    int32_t imag;
+} complex_q31_t;
+
+typedef struct
+{
+    int16_t real;
+    int16_t imag;
+} complex_q15_t;
+
+// Power-of-two complex transform; twiddles use the radix-4 layout of
+// fft_plan_create()
+typedef struct
+{
+    int n;
+    int log2n;
+    int *permutation;
+    complex_q15_t *twiddles;
+} fft_fixed_plan_t;
+
+// Returns NULL unless n is a power of two, or on allocation failure.
+fft_fixed_plan_t *fft_fixed_plan_create(int n);
+void fft_fixed_plan_destroy(fft_fixed_plan_t *plan);
+
+// Forward transform of X[0..plan->n) in place. Returns the block exponent.
+int fft_fixed_execute(const fft_fixed_plan_t *plan, complex_q31_t *X);
+
+// Real-input transform of size n, computed as an n / 2 complex transform
+typedef struct
+{
+    int n;
+    fft_fixed_plan_t *half;
+    complex_q15_t *twiddles; // exp(-2*pi*i*k/n) for k <= n / 4
+} rfft_fixed_plan_t;
+
+// Returns NULL unless n is a power of two >= 4, or on allocation failure.
+rfft_fixed_plan_t *rfft_fixed_plan_create(int n);
+void rfft_fixed_plan_destroy(rfft_fixed_plan_t *plan);
+
+// Transform n real samples into n / 2 + 1 bins of X. Returns the block exponent.
+int rfft_fixed_execute(const rfft_fixed_plan_t *plan, const int32_t *x, complex_q31_t *X);
+
+// |z| by alpha-max-plus-beta-min (alpha = 123/128, beta = 51/128), within 4%
+static inline uint32_t complex_q31_magnitude(complex_q31_t z)
+{
+    uint32_t a = z.real < 0 ? 0u - (uint32_t)z.real : (uint32_t)z.real;
+    uint32_t b = z.imag < 0 ? 0u - (uint32_t)z.imag : (uint32_t)z.imag;
+    uint32_t hi = a > b ? a : b;
+    uint32_t lo = a > b ? b : a;
+    return (uint32_t)(((uint64_t)hi * 123 + (uint64_t)lo * 51) >> 7);
+}
+
+#endif // FFT_FIXED_H
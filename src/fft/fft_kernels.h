@@ -0,0 +1,39 @@
+#ifndef FFT_KERNELS_H
+#define FFT_KERNELS_H
+
+#include "fft.h"
+
+// All butterfly passes of one fixed-size transform, see fft_specialized.cpp
+typedef void (*fft_stages_fn)(complex_t *X);
+
+// Butterfly kernels for one instruction set. Data is array-of-structs complex_t
+// in bit-reversed order; twiddles use the per-stage layout from fft_plan_create().
+typedef struct fft_kernels
+{
+    const char *name;
+    void (*radix2_first_stage)(complex_t *X, int n);
+    void (*radix4_stage)(complex_t *X, int n, int m, const complex_t *w);
+    // Same pass over count independent arrays, loading each twiddle once
+    void (*radix4_stage_batch)(complex_t *const *X, int count, int n, int m, const complex_t *w);
+    // Compile-time specialized passes for size n, or NULL to use the stages above
+    fft_stages_fn (*specialized_stages)(int n);
+} fft_kernels_t;
+
+// Each getter returns NULL when the instruction set is not available at
+// compile time or on the running CPU.
+const fft_kernels_t *fft_kernels_scalar(void);
+const fft_kernels_t *fft_kernels_avx2(void);
+const fft_kernels_t *fft_kernels_neon(void);
+
+// Specializations for the production window sizes; NULL for other sizes.
+fft_stages_fn fft_specialized_stages_scalar(int n);
+fft_stages_fn fft_specialized_stages_avx2(int n);
+fft_stages_fn fft_specialized_stages_neon(int n);
+
+// Radix-2/3/4/5 passes for FFT_PLAN_MIXED_RADIX plans on digit-reversed data.
+void fft_mixed_radix_stages(const fft_plan_t *plan, complex_t *X);
+
+// Best kernels for the running CPU, selected once on first use.
+const fft_kernels_t *fft_kernels_select(void);
+
+#endif // FFT_KERNELS_H
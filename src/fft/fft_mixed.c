@@ -0,0 +1,173 @@
+#include "fft_kernels.h"
+
+// Butterfly passes for sizes 2^a * 3^b * 5^c. The input has already been
+// scattered into digit-reversed order, so pass s combines p_s consecutive
+// sub-transforms of size m = p_1 * ... * p_(s-1) into transforms of size p_s * m.
+// Twiddles for a pass are stored as w^(r*k) for k < m, 1 <= r < p_s.
+
+static const nst_real_t HALF = 0.5;
+static const nst_real_t SIN_60 = 0.86602540378443864676;
+static const nst_real_t COS_72 = 0.30901699437494742410;
+static const nst_real_t SIN_72 = 0.95105651629515357212;
+static const nst_real_t COS_144 = -0.80901699437494742410;
+static const nst_real_t SIN_144 = 0.58778525229247312917;
+
+static inline complex_t cmul(complex_t a, complex_t b)
+{
+    complex_t result;
+    result.real = a.real * b.real - a.imag * b.imag;
+    result.imag = a.real * b.imag + a.imag * b.real;
+    return result;
+}
+
+static void radix2_pass(complex_t *X, int n, int m, const complex_t *w)
+{
+    for (int group = 0; group < n; group += 2 * m)
+    {
+        complex_t *x0 = X + group;
+        complex_t *x1 = x0 + m;
+        for (int k = 0; k < m; k++)
+        {
+            complex_t a0 = x0[k];
+            complex_t a1 = cmul(x1[k], w[k]);
+            x0[k].real = a0.real + a1.real;
+            x0[k].imag = a0.imag + a1.imag;
+            x1[k].real = a0.real - a1.real;
+            x1[k].imag = a0.imag - a1.imag;
+        }
+    }
+}
+
+static void radix3_pass(complex_t *X, int n, int m, const complex_t *w)
+{
+    for (int group = 0; group < n; group += 3 * m)
+    {
+        complex_t *x0 = X + group;
+        complex_t *x1 = x0 + m;
+        complex_t *x2 = x1 + m;
+        for (int k = 0; k < m; k++)
+        {
+            complex_t a0 = x0[k];
+            complex_t a1 = cmul(x1[k], w[2 * k]);
+            complex_t a2 = cmul(x2[k], w[2 * k + 1]);
+
+            nst_real_t tr = a1.real + a2.real, ti = a1.imag + a2.imag;
+            nst_real_t ur = a0.real - HALF * tr, ui = a0.imag - HALF * ti;
+            // -i * sin(60) * (a1 - a2)
+            nst_real_t vr = SIN_60 * (a1.imag - a2.imag);
+            nst_real_t vi = -SIN_60 * (a1.real - a2.real);
+
+            x0[k].real = a0.real + tr;
+            x0[k].imag = a0.imag + ti;
+            x1[k].real = ur + vr;
+            x1[k].imag = ui + vi;
+            x2[k].real = ur - vr;
+            x2[k].imag = ui - vi;
+        }
+    }
+}
+
+static void radix4_pass(complex_t *X, int n, int m, const complex_t *w)
+{
+    for (int group = 0; group < n; group += 4 * m)
+    {
+        complex_t *x0 = X + group;
+        complex_t *x1 = x0 + m;
+        complex_t *x2 = x1 + m;
+        complex_t *x3 = x2 + m;
+        for (int k = 0; k < m; k++)
+        {
+            complex_t a0 = x0[k];
+            complex_t a1 = cmul(x1[k], w[3 * k]);
+            complex_t a2 = cmul(x2[k], w[3 * k + 1]);
+            complex_t a3 = cmul(x3[k], w[3 * k + 2]);
+
+            nst_real_t s0r = a0.real + a2.real, s0i = a0.imag + a2.imag;
+            nst_real_t d0r = a0.real - a2.real, d0i = a0.imag - a2.imag;
+            nst_real_t s1r = a1.real + a3.real, s1i = a1.imag + a3.imag;
+            nst_real_t d1r = a1.real - a3.real, d1i = a1.imag - a3.imag;
+
+            x0[k].real = s0r + s1r;
+            x0[k].imag = s0i + s1i;
+            x2[k].real = s0r - s1r;
+            x2[k].imag = s0i - s1i;
+            // (a0 - a2) -/+ i * (a1 - a3)
+            x1[k].real = d0r + d1i;
+            x1[k].imag = d0i - d1r;
+            x3[k].real = d0r - d1i;
+            x3[k].imag = d0i + d1r;
+        }
+    }
+}
+
+static void radix5_pass(complex_t *X, int n, int m, const complex_t *w)
+{
+    for (int group = 0; group < n; group += 5 * m)
+    {
+        complex_t *x0 = X + group;
+        complex_t *x1 = x0 + m;
+        complex_t *x2 = x1 + m;
+        complex_t *x3 = x2 + m;
+        complex_t *x4 = x3 + m;
+        for (int k = 0; k < m; k++)
+        {
+            complex_t a0 = x0[k];
+            complex_t a1 = cmul(x1[k], w[4 * k]);
+            complex_t a2 = cmul(x2[k], w[4 * k + 1]);
+            complex_t a3 = cmul(x3[k], w[4 * k + 2]);
+            complex_t a4 = cmul(x4[k], w[4 * k + 3]);
+
+            nst_real_t b1r = a1.real + a4.real, b1i = a1.imag + a4.imag;
+            nst_real_t b2r = a2.real + a3.real, b2i = a2.imag + a3.imag;
+            nst_real_t d1r = a1.real - a4.real, d1i = a1.imag - a4.imag;
+            nst_real_t d2r = a2.real - a3.real, d2i = a2.imag - a3.imag;
+
+            nst_real_t c1r = a0.real + COS_72 * b1r + COS_144 * b2r;
+            nst_real_t c1i = a0.imag + COS_72 * b1i + COS_144 * b2i;
+            nst_real_t c2r = a0.real + COS_144 * b1r + COS_72 * b2r;
+            nst_real_t c2i = a0.imag + COS_144 * b1i + COS_72 * b2i;
+
+            // -i * s, with s1 = sin72*d1 + sin144*d2 and s2 = sin144*d1 - sin72*d2
+            nst_real_t s1r = SIN_72 * d1r + SIN_144 * d2r, s1i = SIN_72 * d1i + SIN_144 * d2i;
+            nst_real_t s2r = SIN_144 * d1r - SIN_72 * d2r, s2i = SIN_144 * d1i - SIN_72 * d2i;
+
+            x0[k].real = a0.real + b1r + b2r;
+            x0[k].imag = a0.imag + b1i + b2i;
+            x1[k].real = c1r + s1i;
+            x1[k].imag = c1i - s1r;
+            x4[k].real = c1r - s1i;
+            x4[k].imag = c1i + s1r;
+            x2[k].real = c2r + s2i;
+            x2[k].imag = c2i - s2r;
+            x3[k].real = c2r - s2i;
+            x3[k].imag = c2i + s2r;
+        }
+    }
+}
+
+void fft_mixed_radix_stages(const fft_plan_t *plan, complex_t *X)
+{
+    const complex_t *w = plan->twiddles;
+    int m = 1;
+    for (int s = 0; s < plan->factor_count; s++)
+    {
+        int p = plan->factors[s];
+        switch (p)
+        {
+        case 2:
+            radix2_pass(X, plan->n, m, w);
+            break;
+        case 3:
+            radix3_pass(X, plan->n, m, w);
+            break;
+        case 4:
+            radix4_pass(X, plan->n, m, w);
+            break;
+        case 5:
+            radix5_pass(X, plan->n, m, w);
+            break;
+        }
+        w += (p - 1) * m;
+        m *= p;
+    }
+}
@@ -0,0 +1,297 @@
+#include "fft_kernels.h"
+#include <stddef.h>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+#ifndef NST_SINGLE_PRECISION
+
+// One interleaved complex value per register: [re, im]
+static inline float64x2_t cmul1(float64x2_t a, float64x2_t w)
+{
+    const float64x2_t sign = {-1.0, 1.0};
+    float64x2_t a_swap = vextq_f64(a, a, 1);
+    float64x2_t re = vmulq_laneq_f64(a, w, 0);
+    return vfmaq_f64(re, vmulq_laneq_f64(a_swap, w, 1), sign);
+}
+
+// Multiply by -i: (re, im) -> (im, -re)
+static inline float64x2_t mul_neg_i1(float64x2_t a)
+{
+    const float64x2_t sign = {1.0, -1.0};
+    return vmulq_f64(vextq_f64(a, a, 1), sign);
+}
+
+static void neon_radix2_first_stage(complex_t *X, int n)
+{
+    double *x = (double *)X;
+    for (int i = 0; i < n; i += 2)
+    {
+        float64x2_t a = vld1q_f64(x + 2 * i);
+        float64x2_t b = vld1q_f64(x + 2 * i + 2);
+        vst1q_f64(x + 2 * i, vaddq_f64(a, b));
+        vst1q_f64(x + 2 * i + 2, vsubq_f64(a, b));
+    }
+}
+
+static inline void neon_butterfly(double *x0, double *x1, double *x2, double *x3,
+                                  float64x2_t t1, float64x2_t t2, float64x2_t t3)
+{
+    float64x2_t a0 = vld1q_f64(x0);
+    float64x2_t s0 = vaddq_f64(a0, t1);
+    float64x2_t d0 = vsubq_f64(a0, t1);
+    float64x2_t s1 = vaddq_f64(t2, t3);
+    float64x2_t d1 = mul_neg_i1(vsubq_f64(t2, t3));
+
+    vst1q_f64(x0, vaddq_f64(s0, s1));
+    vst1q_f64(x1, vaddq_f64(d0, d1));
+    vst1q_f64(x2, vsubq_f64(s0, s1));
+    vst1q_f64(x3, vsubq_f64(d0, d1));
+}
+
+static void neon_radix4_stage(complex_t *X, int n, int m, const complex_t *w)
+{
+    if (m == 1)
+    {
+        // Unit twiddles
+        double *x = (double *)X;
+        for (int group = 0; group < n; group += 4)
+        {
+            double *p = x + 2 * group;
+            neon_butterfly(p, p + 2, p + 4, p + 6, vld1q_f64(p + 2), vld1q_f64(p + 4), vld1q_f64(p + 6));
+        }
+        return;
+    }
+
+    const double *w1 = (const double *)w;
+    const double *w2 = (const double *)(w + m);
+    const double *w3 = (const double *)(w + 2 * m);
+
+    for (int group = 0; group < n; group += 4 * m)
+    {
+        double *x0 = (double *)(X + group);
+        double *x1 = x0 + 2 * m;
+        double *x2 = x1 + 2 * m;
+        double *x3 = x2 + 2 * m;
+
+        // Two butterflies per iteration to keep both FMA pipes busy
+        for (int k = 0; k < 2 * m; k += 4)
+        {
+            float64x2_t t1a = cmul1(vld1q_f64(x1 + k), vld1q_f64(w2 + k));
+            float64x2_t t2a = cmul1(vld1q_f64(x2 + k), vld1q_f64(w1 + k));
+            float64x2_t t3a = cmul1(vld1q_f64(x3 + k), vld1q_f64(w3 + k));
+            float64x2_t t1b = cmul1(vld1q_f64(x1 + k + 2), vld1q_f64(w2 + k + 2));
+            float64x2_t t2b = cmul1(vld1q_f64(x2 + k + 2), vld1q_f64(w1 + k + 2));
+            float64x2_t t3b = cmul1(vld1q_f64(x3 + k + 2), vld1q_f64(w3 + k + 2));
+
+            neon_butterfly(x0 + k, x1 + k, x2 + k, x3 + k, t1a, t2a, t3a);
+            neon_butterfly(x0 + k + 2, x1 + k + 2, x2 + k + 2, x3 + k + 2, t1b, t2b, t3b);
+        }
+    }
+}
+
+static void neon_radix4_stage_batch(complex_t *const *X, int count, int n, int m, const complex_t *w)
+{
+    if (m == 1)
+    {
+        for (int c = 0; c < count; c++)
+        {
+            neon_radix4_stage(X[c], n, 1, w);
+        }
+        return;
+    }
+
+    const double *w1 = (const double *)w;
+    const double *w2 = (const double *)(w + m);
+    const double *w3 = (const double *)(w + 2 * m);
+
+    for (int group = 0; group < n; group += 4 * m)
+    {
+        for (int k = 0; k < 2 * m; k += 2)
+        {
+            // Load the twiddles once and reuse them for every array
+            float64x2_t v1 = vld1q_f64(w1 + k);
+            float64x2_t v2 = vld1q_f64(w2 + k);
+            float64x2_t v3 = vld1q_f64(w3 + k);
+
+            for (int c = 0; c < count; c++)
+            {
+                double *x0 = (double *)(X[c] + group) + k;
+                double *x1 = x0 + 2 * m;
+                double *x2 = x1 + 2 * m;
+                double *x3 = x2 + 2 * m;
+                neon_butterfly(x0, x1, x2, x3,
+                               cmul1(vld1q_f64(x1), v2), cmul1(vld1q_f64(x2), v1), cmul1(vld1q_f64(x3), v3));
+            }
+        }
+    }
+}
+
+#else
+
+// Two interleaved complex values per register: [re0, im0, re1, im1]
+static inline float32x4_t cmul2(float32x4_t a, float32x4_t w)
+{
+    const float32x4_t sign = {-1.0f, 1.0f, -1.0f, 1.0f};
+    float32x4_t re = vmulq_f32(a, vtrn1q_f32(w, w));
+    float32x4_t a_swap = vrev64q_f32(a);
+    return vfmaq_f32(re, vmulq_f32(a_swap, vtrn2q_f32(w, w)), sign);
+}
+
+// Multiply by -i: (re, im) -> (im, -re)
+static inline float32x4_t mul_neg_i2(float32x4_t a)
+{
+    const float32x4_t sign = {1.0f, -1.0f, 1.0f, -1.0f};
+    return vmulq_f32(vrev64q_f32(a), sign);
+}
+
+static void neon_radix2_first_stage(complex_t *X, int n)
+{
+    float *x = (float *)X;
+    for (int i = 0; i < n; i += 2)
+    {
+        float32x4_t v = vld1q_f32(x + 2 * i);
+        float32x2_t a = vget_low_f32(v);
+        float32x2_t b = vget_high_f32(v);
+        vst1q_f32(x + 2 * i, vcombine_f32(vadd_f32(a, b), vsub_f32(a, b)));
+    }
+}
+
+static inline void neon_butterfly(float *x0, float *x1, float *x2, float *x3,
+                                  float32x4_t t1, float32x4_t t2, float32x4_t t3)
+{
+    float32x4_t a0 = vld1q_f32(x0);
+    float32x4_t s0 = vaddq_f32(a0, t1);
+    float32x4_t d0 = vsubq_f32(a0, t1);
+    float32x4_t s1 = vaddq_f32(t2, t3);
+    float32x4_t d1 = mul_neg_i2(vsubq_f32(t2, t3));
+
+    vst1q_f32(x0, vaddq_f32(s0, s1));
+    vst1q_f32(x1, vaddq_f32(d0, d1));
+    vst1q_f32(x2, vsubq_f32(s0, s1));
+    vst1q_f32(x3, vsubq_f32(d0, d1));
+}
+
+// Unit twiddles, one butterfly per group: pair the values as [a0, a2] and
+// [a1, a3], then [s0, d0] and [s1, d1]
+static void neon_radix4_unit_stage(complex_t *X, int n)
+{
+    const float32x2_t sign = {1.0f, -1.0f};
+    float *x = (float *)X;
+    for (int group = 0; group < n; group += 4)
+    {
+        float *p = x + 2 * group;
+        float32x4_t v0 = vld1q_f32(p);
+        float32x4_t v1 = vld1q_f32(p + 4);
+
+        float32x4_t even = vcombine_f32(vget_low_f32(v0), vget_low_f32(v1));
+        float32x4_t odd = vcombine_f32(vget_high_f32(v0), vget_high_f32(v1));
+        float32x4_t sum = vaddq_f32(even, odd);
+        float32x4_t diff = vsubq_f32(even, odd);
+        float32x2_t d1 = vmul_f32(vrev64_f32(vget_high_f32(diff)), sign);
+
+        float32x4_t lo = vcombine_f32(vget_low_f32(sum), vget_low_f32(diff));
+        float32x4_t hi = vcombine_f32(vget_high_f32(sum), d1);
+        vst1q_f32(p, vaddq_f32(lo, hi));
+        vst1q_f32(p + 4, vsubq_f32(lo, hi));
+    }
+}
+
+static void neon_radix4_stage(complex_t *X, int n, int m, const complex_t *w)
+{
+    if (m == 1)
+    {
+        neon_radix4_unit_stage(X, n);
+        return;
+    }
+
+    // m is a power of two >= 2, so k advances two complex values at a time
+    const float *w1 = (const float *)w;
+    const float *w2 = (const float *)(w + m);
+    const float *w3 = (const float *)(w + 2 * m);
+
+    for (int group = 0; group < n; group += 4 * m)
+    {
+        float *x0 = (float *)(X + group);
+        float *x1 = x0 + 2 * m;
+        float *x2 = x1 + 2 * m;
+        float *x3 = x2 + 2 * m;
+
+        for (int k = 0; k < 2 * m; k += 4)
+        {
+            neon_butterfly(x0 + k, x1 + k, x2 + k, x3 + k,
+                           cmul2(vld1q_f32(x1 + k), vld1q_f32(w2 + k)),
+                           cmul2(vld1q_f32(x2 + k), vld1q_f32(w1 + k)),
+                           cmul2(vld1q_f32(x3 + k), vld1q_f32(w3 + k)));
+        }
+    }
+}
+
+static void neon_radix4_stage_batch(complex_t *const *X, int count, int n, int m, const complex_t *w)
+{
+    if (m == 1)
+    {
+        for (int c = 0; c < count; c++)
+        {
+            neon_radix4_unit_stage(X[c], n);
+        }
+        return;
+    }
+
+    const float *w1 = (const float *)w;
+    const float *w2 = (const float *)(w + m);
+    const float *w3 = (const float *)(w + 2 * m);
+
+    for (int group = 0; group < n; group += 4 * m)
+    {
+        for (int k = 0; k < 2 * m; k += 4)
+        {
+            // Load the twiddles once and reuse them for every array
+            float32x4_t v1 = vld1q_f32(w1 + k);
+            float32x4_t v2 = vld1q_f32(w2 + k);
+            float32x4_t v3 = vld1q_f32(w3 + k);
+
+            for (int c = 0; c < count; c++)
+            {
+                float *x0 = (float *)(X[c] + group) + k;
+                float *x1 = x0 + 2 * m;
+                float *x2 = x1 + 2 * m;
+                float *x3 = x2 + 2 * m;
+                neon_butterfly(x0, x1, x2, x3,
+                               cmul2(vld1q_f32(x1), v2), cmul2(vld1q_f32(x2), v1), cmul2(vld1q_f32(x3), v3));
+            }
+        }
+    }
+}
+
+#endif
+
+static const fft_kernels_t neon_kernels = {
+    "neon",
+    neon_radix2_first_stage,
+    neon_radix4_stage,
+    neon_radix4_stage_batch,
+    fft_specialized_stages_neon,
+};
+
+const fft_kernels_t *fft_kernels_neon(void)
+{
+#if defined(__linux__) && defined(HWCAP_ASIMD)
+    if (!(getauxval(AT_HWCAP) & HWCAP_ASIMD))
+        return NULL;
+#endif
+    return &neon_kernels;
+}
+
+#else
+
+const fft_kernels_t *fft_kernels_neon(void)
+{
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,103 @@
+#include "fft_kernels.h"
+
+static void scalar_radix2_first_stage(complex_t *X, int n)
+{
+    for (int i = 0; i < n; i += 2)
+    {
+        complex_t a = X[i];
+        complex_t b = X[i + 1];
+        X[i].real = a.real + b.real;
+        X[i].imag = a.imag + b.imag;
+        X[i + 1].real = a.real - b.real;
+        X[i + 1].imag = a.imag - b.imag;
+    }
+}
+
+static inline void scalar_butterfly(complex_t *x0, complex_t *x1, complex_t *x2, complex_t *x3,
+                                    complex_t w1, complex_t w2, complex_t w3)
+{
+    complex_t a0 = *x0;
+    complex_t a1 = *x1;
+    complex_t a2 = *x2;
+    complex_t a3 = *x3;
+
+    // t1 = w^2k * a1 (residue 2), t2 = w^k * a2 (residue 1), t3 = w^3k * a3
+    nst_real_t t1r = a1.real * w2.real - a1.imag * w2.imag;
+    nst_real_t t1i = a1.real * w2.imag + a1.imag * w2.real;
+    nst_real_t t2r = a2.real * w1.real - a2.imag * w1.imag;
+    nst_real_t t2i = a2.real * w1.imag + a2.imag * w1.real;
+    nst_real_t t3r = a3.real * w3.real - a3.imag * w3.imag;
+    nst_real_t t3i = a3.real * w3.imag + a3.imag * w3.real;
+
+    nst_real_t s0r = a0.real + t1r, s0i = a0.imag + t1i;
+    nst_real_t d0r = a0.real - t1r, d0i = a0.imag - t1i;
+    nst_real_t s1r = t2r + t3r, s1i = t2i + t3i;
+    nst_real_t d1r = t2r - t3r, d1i = t2i - t3i;
+
+    x0->real = s0r + s1r;
+    x0->imag = s0i + s1i;
+    x2->real = s0r - s1r;
+    x2->imag = s0i - s1i;
+    // (t0 - t1) -/+ i * (t2 - t3)
+    x1->real = d0r + d1i;
+    x1->imag = d0i - d1r;
+    x3->real = d0r - d1i;
+    x3->imag = d0i + d1r;
+}
+
+// Combines four bit-reversed sub-transforms of size m into transforms of size 4m.
+// Block order after bit reversal is residue 0, 2, 1, 3.
+static void scalar_radix4_stage(complex_t *X, int n, int m, const complex_t *w)
+{
+    const complex_t *w1 = w;
+    const complex_t *w2 = w + m;
+    const complex_t *w3 = w + 2 * m;
+
+    for (int group = 0; group < n; group += 4 * m)
+    {
+        complex_t *x0 = X + group;
+        complex_t *x1 = x0 + m;
+        complex_t *x2 = x1 + m;
+        complex_t *x3 = x2 + m;
+
+        for (int k = 0; k < m; k++)
+        {
+            scalar_butterfly(x0 + k, x1 + k, x2 + k, x3 + k, w1[k], w2[k], w3[k]);
+        }
+    }
+}
+
+static void scalar_radix4_stage_batch(complex_t *const *X, int count, int n, int m, const complex_t *w)
+{
+    const complex_t *w1 = w;
+    const complex_t *w2 = w + m;
+    const complex_t *w3 = w + 2 * m;
+
+    for (int group = 0; group < n; group += 4 * m)
+    {
+        for (int k = 0; k < m; k++)
+        {
+            complex_t tw1 = w1[k];
+            complex_t tw2 = w2[k];
+            complex_t tw3 = w3[k];
+            for (int c = 0; c < count; c++)
+            {
+                complex_t *x0 = X[c] + group + k;
+                scalar_butterfly(x0, x0 + m, x0 + 2 * m, x0 + 3 * m, tw1, tw2, tw3);
+            }
+        }
+    }
+}
+
+static const fft_kernels_t scalar_kernels = {
+    "scalar",
+    scalar_radix2_first_stage,
+    scalar_radix4_stage,
+    scalar_radix4_stage_batch,
+    fft_specialized_stages_scalar,
+};
+
+const fft_kernels_t *fft_kernels_scalar(void)
+{
+    return &scalar_kernels;
+}
@@ -0,0 +1,650 @@
+// Fixed-size FFT passes for the window sizes used in production: complex
+// transforms of 32, 256, 1024 and 4096 points and the half-size transforms
+// behind real windows of those lengths. Twiddles are computed at compile time
+// and baked into the binary; passes for small sizes are fully unrolled so
+// every twiddle becomes a constant operand.
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+extern "C"
+{
+#include "fft_kernels.h"
+}
+
+namespace
+{
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Taylor series, accurate to double precision on [0, pi/4]
+constexpr double sin_series(double x)
+{
+    double x2 = x * x;
+    double term = x;
+    double sum = x;
+    for (int i = 1; i < 12; i++)
+    {
+        term *= -x2 / ((2 * i) * (2 * i + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cos_series(double x)
+{
+    double x2 = x * x;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int i = 1; i < 12; i++)
+    {
+        term *= -x2 / ((2 * i - 1) * (2 * i));
+        sum += term;
+    }
+    return sum;
+}
+
+// exp(-2*pi*i*num/den) with exact octant reduction of the rational angle
+constexpr complex_t twiddle(long num, long den)
+{
+    long r = num % den;
+    long octant = (8 * r) / den;
+    double x = kPi * (double)(8 * r - octant * den) / (4.0 * (double)den);
+    double s = sin_series(x);
+    double c = cos_series(x);
+    double sq = 0.70710678118654752440;
+
+    // cos and sin of octant * pi/4 + x
+    double cos_t = 0.0;
+    double sin_t = 0.0;
+    switch (octant)
+    {
+    case 0: cos_t = c; sin_t = s; break;
+    case 1: cos_t = sq * (c - s); sin_t = sq * (c + s); break;
+    case 2: cos_t = -s; sin_t = c; break;
+    case 3: cos_t = -sq * (c + s); sin_t = sq * (c - s); break;
+    case 4: cos_t = -c; sin_t = -s; break;
+    case 5: cos_t = -sq * (c - s); sin_t = -sq * (c + s); break;
+    case 6: cos_t = s; sin_t = -c; break;
+    default: cos_t = sq * (c + s); sin_t = -sq * (c - s); break;
+    }
+    return complex_t{(nst_real_t)cos_t, (nst_real_t)-sin_t};
+}
+
+constexpr int log2_of(int n)
+{
+    int log2n = 0;
+    while ((1 << log2n) < n)
+    {
+        log2n++;
+    }
+    return log2n;
+}
+
+constexpr int first_span(int n)
+{
+    return (log2_of(n) & 1) ? 2 : 1;
+}
+
+// Same per-pass layout as fft_plan_create(): [w^k | w^2k | w^3k] for each m
+template <int N>
+struct twiddle_table
+{
+    std::array<complex_t, N> w{};
+
+    constexpr twiddle_table()
+    {
+        int offset = 0;
+        for (int m = first_span(N); 4 * m <= N; m *= 4)
+        {
+            for (int k = 0; k < m; k++)
+            {
+                w[offset + k] = twiddle(k, 4 * m);
+                w[offset + m + k] = twiddle(2 * k, 4 * m);
+                w[offset + 2 * m + k] = twiddle(3 * k, 4 * m);
+            }
+            offset += 3 * m;
+        }
+    }
+};
+
+template <int N>
+constexpr twiddle_table<N> kTwiddles{};
+
+inline void butterfly(complex_t *x0, complex_t *x1, complex_t *x2, complex_t *x3,
+                      complex_t w1, complex_t w2, complex_t w3)
+{
+    complex_t a0 = *x0;
+    complex_t a1 = *x1;
+    complex_t a2 = *x2;
+    complex_t a3 = *x3;
+
+    // t1 = w^2k * a1 (residue 2), t2 = w^k * a2 (residue 1), t3 = w^3k * a3
+    nst_real_t t1r = a1.real * w2.real - a1.imag * w2.imag;
+    nst_real_t t1i = a1.real * w2.imag + a1.imag * w2.real;
+    nst_real_t t2r = a2.real * w1.real - a2.imag * w1.imag;
+    nst_real_t t2i = a2.real * w1.imag + a2.imag * w1.real;
+    nst_real_t t3r = a3.real * w3.real - a3.imag * w3.imag;
+    nst_real_t t3i = a3.real * w3.imag + a3.imag * w3.real;
+
+    nst_real_t s0r = a0.real + t1r, s0i = a0.imag + t1i;
+    nst_real_t d0r = a0.real - t1r, d0i = a0.imag - t1i;
+    nst_real_t s1r = t2r + t3r, s1i = t2i + t3i;
+    nst_real_t d1r = t2r - t3r, d1i = t2i - t3i;
+
+    x0->real = s0r + s1r;
+    x0->imag = s0i + s1i;
+    x2->real = s0r - s1r;
+    x2->imag = s0i - s1i;
+    x1->real = d0r + d1i;
+    x1->imag = d0i - d1r;
+    x3->real = d0r - d1i;
+    x3->imag = d0i + d1r;
+}
+
+// Butterfly number I of a pass with sub-size M, twiddles at Offset
+template <int N, int M, int Offset, std::size_t I>
+inline void unrolled_butterfly(complex_t *X)
+{
+    constexpr int group = (int)(I / M) * 4 * M;
+    constexpr int k = (int)(I % M);
+    constexpr complex_t w1 = kTwiddles<N>.w[Offset + k];
+    constexpr complex_t w2 = kTwiddles<N>.w[Offset + M + k];
+    constexpr complex_t w3 = kTwiddles<N>.w[Offset + 2 * M + k];
+    complex_t *x0 = X + group + k;
+    butterfly(x0, x0 + M, x0 + 2 * M, x0 + 3 * M, w1, w2, w3);
+}
+
+template <int N, int M, int Offset, std::size_t... I>
+inline void unrolled_pass(complex_t *X, std::index_sequence<I...>)
+{
+    (unrolled_butterfly<N, M, Offset, I>(X), ...);
+}
+
+// Sizes up to this many points get straight-line code
+constexpr int kUnrollLimit = 64;
+
+template <int N, int M, int Offset>
+inline void radix4_passes(complex_t *X)
+{
+    if constexpr (4 * M <= N)
+    {
+        unrolled_pass<N, M, Offset>(X, std::make_index_sequence<N / 4>{});
+        radix4_passes<N, 4 * M, Offset + 3 * M>(X);
+    }
+}
+
+// Without SIMD only the straight-line small sizes beat the generic loops
+template <int N>
+void scalar_specialized_stages(complex_t *X)
+{
+    static_assert(N <= kUnrollLimit, "scalar specializations are fully unrolled");
+    if constexpr (first_span(N) == 2)
+    {
+        for (int i = 0; i < N; i += 2)
+        {
+            complex_t a = X[i];
+            complex_t b = X[i + 1];
+            X[i].real = a.real + b.real;
+            X[i].imag = a.imag + b.imag;
+            X[i + 1].real = a.real - b.real;
+            X[i + 1].imag = a.imag - b.imag;
+        }
+    }
+    radix4_passes<N, first_span(N), 0>(X);
+}
+
+
+// The AVX2 passes use double lanes; single-precision builds keep the
+// generic float kernels from fft_avx2.c
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(NST_SINGLE_PRECISION)
+
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+
+// Same register layout as fft_avx2.c: two interleaved complex values per register
+AVX2_TARGET inline __m256d avx2_cmul2(__m256d a, __m256d w)
+{
+    __m256d a_swap = _mm256_permute_pd(a, 0x5);
+    return _mm256_fmaddsub_pd(a, _mm256_movedup_pd(w), _mm256_mul_pd(a_swap, _mm256_permute_pd(w, 0xF)));
+}
+
+AVX2_TARGET inline __m256d avx2_mul_neg_i2(__m256d a)
+{
+    const __m256d sign = _mm256_set_pd(-0.0, 0.0, -0.0, 0.0);
+    return _mm256_xor_pd(_mm256_permute_pd(a, 0x5), sign);
+}
+
+AVX2_TARGET inline __m128d avx2_mul_neg_i1(__m128d a)
+{
+    const __m128d sign = _mm_set_pd(-0.0, 0.0);
+    return _mm_xor_pd(_mm_shuffle_pd(a, a, 0x1), sign);
+}
+
+// Unit-twiddle radix-4 butterfly on group I
+template <std::size_t I>
+AVX2_TARGET inline void avx2_unit_butterfly(double *x)
+{
+    double *p = x + 8 * I;
+    __m128d a0 = _mm_loadu_pd(p);
+    __m128d a1 = _mm_loadu_pd(p + 2);
+    __m128d a2 = _mm_loadu_pd(p + 4);
+    __m128d a3 = _mm_loadu_pd(p + 6);
+
+    __m128d s0 = _mm_add_pd(a0, a1);
+    __m128d d0 = _mm_sub_pd(a0, a1);
+    __m128d s1 = _mm_add_pd(a2, a3);
+    __m128d d1 = avx2_mul_neg_i1(_mm_sub_pd(a2, a3));
+
+    _mm_storeu_pd(p, _mm_add_pd(s0, s1));
+    _mm_storeu_pd(p + 2, _mm_add_pd(d0, d1));
+    _mm_storeu_pd(p + 4, _mm_sub_pd(s0, s1));
+    _mm_storeu_pd(p + 6, _mm_sub_pd(d0, d1));
+}
+
+// Two butterflies k/2 and k/2 + 1 of the group starting at complex index group
+template <int N, int M, int Offset>
+AVX2_TARGET inline void avx2_butterfly_pair(double *x, int group, int k)
+{
+    const double *w = reinterpret_cast<const double *>(kTwiddles<N>.w.data() + Offset);
+    double *x0 = x + 2 * group + k;
+    double *x1 = x0 + 2 * M;
+    double *x2 = x1 + 2 * M;
+    double *x3 = x2 + 2 * M;
+
+    __m256d a0 = _mm256_loadu_pd(x0);
+    __m256d t1 = avx2_cmul2(_mm256_loadu_pd(x1), _mm256_loadu_pd(w + 2 * M + k));
+    __m256d t2 = avx2_cmul2(_mm256_loadu_pd(x2), _mm256_loadu_pd(w + k));
+    __m256d t3 = avx2_cmul2(_mm256_loadu_pd(x3), _mm256_loadu_pd(w + 4 * M + k));
+
+    __m256d s0 = _mm256_add_pd(a0, t1);
+    __m256d d0 = _mm256_sub_pd(a0, t1);
+    __m256d s1 = _mm256_add_pd(t2, t3);
+    __m256d d1 = avx2_mul_neg_i2(_mm256_sub_pd(t2, t3));
+
+    _mm256_storeu_pd(x0, _mm256_add_pd(s0, s1));
+    _mm256_storeu_pd(x1, _mm256_add_pd(d0, d1));
+    _mm256_storeu_pd(x2, _mm256_sub_pd(s0, s1));
+    _mm256_storeu_pd(x3, _mm256_sub_pd(d0, d1));
+}
+
+template <int N, int M, int Offset, std::size_t... I>
+AVX2_TARGET inline void avx2_unrolled_pass(double *x, std::index_sequence<I...>)
+{
+    if constexpr (M == 1)
+    {
+        (avx2_unit_butterfly<I>(x), ...);
+    }
+    else
+    {
+        (avx2_butterfly_pair<N, M, Offset>(x, (int)(I / (M / 2)) * 4 * M, (int)(I % (M / 2)) * 4), ...);
+    }
+}
+
+template <int N, int M, int Offset>
+AVX2_TARGET inline void avx2_looped_pass(double *x)
+{
+    for (int group = 0; group < N; group += 4 * M)
+    {
+        if constexpr (M == 1)
+        {
+            avx2_unit_butterfly<0>(x + 2 * group);
+        }
+        else
+        {
+            for (int k = 0; k < 2 * M; k += 4)
+            {
+                avx2_butterfly_pair<N, M, Offset>(x, group, k);
+            }
+        }
+    }
+}
+
+template <int N, int M, int Offset>
+AVX2_TARGET inline void avx2_radix4_passes(double *x)
+{
+    if constexpr (4 * M <= N)
+    {
+        if constexpr (N <= kUnrollLimit)
+        {
+            constexpr int count = M == 1 ? N / 4 : N / 8;
+            avx2_unrolled_pass<N, M, Offset>(x, std::make_index_sequence<count>{});
+        }
+        else
+        {
+            avx2_looped_pass<N, M, Offset>(x);
+        }
+        avx2_radix4_passes<N, 4 * M, Offset + 3 * M>(x);
+    }
+}
+
+template <int N>
+AVX2_TARGET void avx2_specialized_stages(complex_t *X)
+{
+    double *x = reinterpret_cast<double *>(X);
+    if constexpr (first_span(N) == 2)
+    {
+        for (int i = 0; i < 2 * N; i += 4)
+        {
+            __m128d a = _mm_loadu_pd(x + i);
+            __m128d b = _mm_loadu_pd(x + i + 2);
+            _mm_storeu_pd(x + i, _mm_add_pd(a, b));
+            _mm_storeu_pd(x + i + 2, _mm_sub_pd(a, b));
+        }
+    }
+    avx2_radix4_passes<N, first_span(N), 0>(x);
+}
+
+#endif
+
+#if defined(__aarch64__)
+
+// Same register layouts as fft_neon.c. The passes below are written once
+// over neon_vec_t and kNeonComplexPerVector values per register.
+#ifndef NST_SINGLE_PRECISION
+
+typedef float64x2_t neon_vec_t;
+constexpr int kNeonComplexPerVector = 1;
+
+inline neon_vec_t neon_load(const nst_real_t *p)
+{
+    return vld1q_f64(p);
+}
+
+inline void neon_store(nst_real_t *p, neon_vec_t v)
+{
+    vst1q_f64(p, v);
+}
+
+inline neon_vec_t neon_add(neon_vec_t a, neon_vec_t b)
+{
+    return vaddq_f64(a, b);
+}
+
+inline neon_vec_t neon_sub(neon_vec_t a, neon_vec_t b)
+{
+    return vsubq_f64(a, b);
+}
+
+inline neon_vec_t neon_cmul(neon_vec_t a, neon_vec_t w)
+{
+    const float64x2_t sign = {-1.0, 1.0};
+    float64x2_t a_swap = vextq_f64(a, a, 1);
+    float64x2_t re = vmulq_laneq_f64(a, w, 0);
+    return vfmaq_f64(re, vmulq_laneq_f64(a_swap, w, 1), sign);
+}
+
+// Multiply by -i: (re, im) -> (im, -re)
+inline neon_vec_t neon_mul_neg_i(neon_vec_t a)
+{
+    const float64x2_t sign = {1.0, -1.0};
+    return vmulq_f64(vextq_f64(a, a, 1), sign);
+}
+
+// Radix-2 butterfly on the two complex values at p
+inline void neon_radix2_pair(nst_real_t *p)
+{
+    float64x2_t a = vld1q_f64(p);
+    float64x2_t b = vld1q_f64(p + 2);
+    vst1q_f64(p, vaddq_f64(a, b));
+    vst1q_f64(p + 2, vsubq_f64(a, b));
+}
+
+#else
+
+typedef float32x4_t neon_vec_t;
+constexpr int kNeonComplexPerVector = 2;
+
+inline neon_vec_t neon_load(const nst_real_t *p)
+{
+    return vld1q_f32(p);
+}
+
+inline void neon_store(nst_real_t *p, neon_vec_t v)
+{
+    vst1q_f32(p, v);
+}
+
+inline neon_vec_t neon_add(neon_vec_t a, neon_vec_t b)
+{
+    return vaddq_f32(a, b);
+}
+
+inline neon_vec_t neon_sub(neon_vec_t a, neon_vec_t b)
+{
+    return vsubq_f32(a, b);
+}
+
+inline neon_vec_t neon_cmul(neon_vec_t a, neon_vec_t w)
+{
+    const float32x4_t sign = {-1.0f, 1.0f, -1.0f, 1.0f};
+    float32x4_t re = vmulq_f32(a, vtrn1q_f32(w, w));
+    float32x4_t a_swap = vrev64q_f32(a);
+    return vfmaq_f32(re, vmulq_f32(a_swap, vtrn2q_f32(w, w)), sign);
+}
+
+// Multiply by -i: (re, im) -> (im, -re)
+inline neon_vec_t neon_mul_neg_i(neon_vec_t a)
+{
+    const float32x4_t sign = {1.0f, -1.0f, 1.0f, -1.0f};
+    return vmulq_f32(vrev64q_f32(a), sign);
+}
+
+inline void neon_radix2_pair(nst_real_t *p)
+{
+    float32x4_t v = vld1q_f32(p);
+    float32x2_t a = vget_low_f32(v);
+    float32x2_t b = vget_high_f32(v);
+    vst1q_f32(p, vcombine_f32(vadd_f32(a, b), vsub_f32(a, b)));
+}
+
+#endif
+
+// Radix-4 butterflies on the kNeonComplexPerVector values at x0..x3, with
+// the twiddle products t1..t3 already applied
+inline void neon_butterfly(nst_real_t *x0, nst_real_t *x1, nst_real_t *x2, nst_real_t *x3,
+                           neon_vec_t t1, neon_vec_t t2, neon_vec_t t3)
+{
+    neon_vec_t a0 = neon_load(x0);
+    neon_vec_t s0 = neon_add(a0, t1);
+    neon_vec_t d0 = neon_sub(a0, t1);
+    neon_vec_t s1 = neon_add(t2, t3);
+    neon_vec_t d1 = neon_mul_neg_i(neon_sub(t2, t3));
+
+    neon_store(x0, neon_add(s0, s1));
+    neon_store(x1, neon_add(d0, d1));
+    neon_store(x2, neon_sub(s0, s1));
+    neon_store(x3, neon_sub(d0, d1));
+}
+
+// Unit-twiddle radix-4 butterfly on the group of four values at p
+inline void neon_unit_butterfly(nst_real_t *p)
+{
+#ifndef NST_SINGLE_PRECISION
+    neon_butterfly(p, p + 2, p + 4, p + 6, vld1q_f64(p + 2), vld1q_f64(p + 4), vld1q_f64(p + 6));
+#else
+    // Pair the values as [a0, a2] and [a1, a3], then [s0, d0] and [s1, d1]
+    const float32x2_t sign = {1.0f, -1.0f};
+    float32x4_t v0 = vld1q_f32(p);
+    float32x4_t v1 = vld1q_f32(p + 4);
+
+    float32x4_t even = vcombine_f32(vget_low_f32(v0), vget_low_f32(v1));
+    float32x4_t odd = vcombine_f32(vget_high_f32(v0), vget_high_f32(v1));
+    float32x4_t sum = vaddq_f32(even, odd);
+    float32x4_t diff = vsubq_f32(even, odd);
+    float32x2_t d1 = vmul_f32(vrev64_f32(vget_high_f32(diff)), sign);
+
+    float32x4_t lo = vcombine_f32(vget_low_f32(sum), vget_low_f32(diff));
+    float32x4_t hi = vcombine_f32(vget_high_f32(sum), d1);
+    vst1q_f32(p, vaddq_f32(lo, hi));
+    vst1q_f32(p + 4, vsubq_f32(lo, hi));
+#endif
+}
+
+// Butterflies k / 2 onwards of the group starting at complex index group
+template <int N, int M, int Offset>
+inline void neon_butterflies(nst_real_t *x, int group, int k)
+{
+    const nst_real_t *w = reinterpret_cast<const nst_real_t *>(kTwiddles<N>.w.data() + Offset);
+    nst_real_t *x0 = x + 2 * group + k;
+    nst_real_t *x1 = x0 + 2 * M;
+    nst_real_t *x2 = x1 + 2 * M;
+    nst_real_t *x3 = x2 + 2 * M;
+    neon_butterfly(x0, x1, x2, x3,
+                   neon_cmul(neon_load(x1), neon_load(w + 2 * M + k)),
+                   neon_cmul(neon_load(x2), neon_load(w + k)),
+                   neon_cmul(neon_load(x3), neon_load(w + 4 * M + k)));
+}
+
+// Registers per group of a pass with sub-size M > 1
+template <int M>
+constexpr int kNeonVectorsPerGroup = M / kNeonComplexPerVector;
+
+template <int N, int M, int Offset, std::size_t... I>
+inline void neon_unrolled_pass(nst_real_t *x, std::index_sequence<I...>)
+{
+    if constexpr (M == 1)
+    {
+        (neon_unit_butterfly(x + 8 * I), ...);
+    }
+    else
+    {
+        constexpr int per_group = kNeonVectorsPerGroup<M>;
+        (neon_butterflies<N, M, Offset>(x, (int)(I / per_group) * 4 * M,
+                                        (int)(I % per_group) * 2 * kNeonComplexPerVector),
+         ...);
+    }
+}
+
+template <int N, int M, int Offset>
+inline void neon_looped_pass(nst_real_t *x)
+{
+    for (int group = 0; group < N; group += 4 * M)
+    {
+        if constexpr (M == 1)
+        {
+            neon_unit_butterfly(x + 2 * group);
+        }
+        else
+        {
+            for (int k = 0; k < 2 * M; k += 2 * kNeonComplexPerVector)
+            {
+                neon_butterflies<N, M, Offset>(x, group, k);
+            }
+        }
+    }
+}
+
+template <int N, int M, int Offset>
+inline void neon_radix4_passes(nst_real_t *x)
+{
+    if constexpr (4 * M <= N)
+    {
+        if constexpr (N <= kUnrollLimit)
+        {
+            constexpr int count = M == 1 ? N / 4 : N / 4 / kNeonComplexPerVector;
+            neon_unrolled_pass<N, M, Offset>(x, std::make_index_sequence<count>{});
+        }
+        else
+        {
+            neon_looped_pass<N, M, Offset>(x);
+        }
+        neon_radix4_passes<N, 4 * M, Offset + 3 * M>(x);
+    }
+}
+
+template <int N>
+void neon_specialized_stages(complex_t *X)
+{
+    nst_real_t *x = reinterpret_cast<nst_real_t *>(X);
+    if constexpr (first_span(N) == 2)
+    {
+        for (int i = 0; i < 2 * N; i += 4)
+        {
+            neon_radix2_pair(x + i);
+        }
+    }
+    neon_radix4_passes<N, first_span(N), 0>(x);
+}
+
+#endif
+
+} // namespace
+
+extern "C" fft_stages_fn fft_specialized_stages_scalar(int n)
+{
+    switch (n)
+    {
+    case 16:
+        return scalar_specialized_stages<16>;
+    case 32:
+        return scalar_specialized_stages<32>;
+    default:
+        return nullptr;
+    }
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(NST_SINGLE_PRECISION)
+
+extern "C" fft_stages_fn fft_specialized_stages_avx2(int n)
+{
+    switch (n)
+    {
+    case 16:
+        return avx2_specialized_stages<16>;
+    case 32:
+        return avx2_specialized_stages<32>;
+    case 128:
+        return avx2_specialized_stages<128>;
+    case 256:
+        return avx2_specialized_stages<256>;
+    case 512:
+        return avx2_specialized_stages<512>;
+    case 1024:
+        return avx2_specialized_stages<1024>;
+    case 2048:
+        return avx2_specialized_stages<2048>;
+    case 4096:
+        return avx2_specialized_stages<4096>;
+    default:
+        return nullptr;
+    }
+}
+
+#endif
+
+#if defined(__aarch64__)
+
+extern "C" fft_stages_fn fft_specialized_stages_neon(int n)
+{
+    switch (n)
+    {
+    case 16:
+        return neon_specialized_stages<16>;
+    case 32:
+        return neon_specialized_stages<32>;
+    case 128:
+        return neon_specialized_stages<128>;
+    case 256:
+        return neon_specialized_stages<256>;
+    case 512:
+        return neon_specialized_stages<512>;
+    case 1024:
+        return neon_specialized_stages<1024>;
+    case 2048:
+        return neon_specialized_stages<2048>;
+    case 4096:
+        return neon_specialized_stages<4096>;
+    default:
+        return nullptr;
+    }
+}
+
+#endif
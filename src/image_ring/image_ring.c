@@ -0,0 +1,95 @@
+#include "image_ring.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+image_ring_t *image_ring_create(unsigned width, unsigned height, unsigned bytes_per_pixel)
+{
+    if (width == 0 || height == 0 || bytes_per_pixel == 0)
+        return NULL;
+
+    image_ring_t *ring = (image_ring_t *)calloc(1, sizeof(image_ring_t));
+    if (!ring)
+        return NULL;
+
+    size_t row_bytes = (size_t)width * bytes_per_pixel;
+    ring->width = width;
+    ring->height = height;
+    ring->bytes_per_pixel = bytes_per_pixel;
+    ring->stride = (row_bytes + IMAGE_RING_ALIGNMENT - 1) / IMAGE_RING_ALIGNMENT * IMAGE_RING_ALIGNMENT;
+    ring->allocation = calloc(1, ring->stride * height + IMAGE_RING_ALIGNMENT - 1);
+    if (!ring->allocation)
+    {
+        free(ring);
+        return NULL;
+    }
+    uintptr_t base = (uintptr_t)ring->allocation;
+    ring->data = (unsigned char *)((base + IMAGE_RING_ALIGNMENT - 1) & ~(uintptr_t)(IMAGE_RING_ALIGNMENT - 1));
+    return ring;
+}
+
+void image_ring_destroy(image_ring_t *ring)
+{
+    if (!ring)
+        return;
+    free(ring->allocation);
+    free(ring);
+}
+
+void image_ring_push_column(image_ring_t *ring, const void *column)
+{
+    unsigned char *out = image_ring_pixel(ring, ring->head, 0);
+    const unsigned char *in = (const unsigned char *)column;
+    size_t stride = ring->stride;
+    unsigned height = ring->height;
+
+    // Fixed-size copies for the pixel formats in use compile to single stores
+    switch (ring->bytes_per_pixel)
+    {
+    case 1:
+        for (unsigned y = 0; y < height; y++)
+        {
+            out[y * stride] = in[y];
+        }
+        break;
+    case 4:
+        for (unsigned y = 0; y < height; y++)
+        {
+            memcpy(out + y * stride, in + 4 * y, 4);
+        }
+        break;
+    default:
+        for (unsigned y = 0; y < height; y++)
+        {
+            memcpy(out + y * stride, in + (size_t)y * ring->bytes_per_pixel, ring->bytes_per_pixel);
+        }
+        break;
+    }
+
+    ring->head = ring->head + 1 == ring->width ? 0 : ring->head + 1;
+}
+
+int image_ring_row(const image_ring_t *ring, unsigned y, image_ring_span_t spans[2])
+{
+    const unsigned char *row = ring->data + y * ring->stride;
+    size_t bpp = ring->bytes_per_pixel;
+
+    spans[0].data = row + ring->head * bpp;
+    spans[0].bytes = (ring->width - ring->head) * bpp;
+    if (ring->head == 0)
+        return 1;
+    spans[1].data = row;
+    spans[1].bytes = ring->head * bpp;
+    return 2;
+}
+
+void image_ring_copy_row(const image_ring_t *ring, unsigned y, unsigned char *out)
+{
+    image_ring_span_t spans[2];
+    int count = image_ring_row(ring, y, spans);
+    memcpy(out, spans[0].data, spans[0].bytes);
+    if (count == 2)
+    {
+        memcpy(out + spans[0].bytes, spans[1].data, spans[1].bytes);
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef IMAGE_RING_H
+#define IMAGE_RING_H
+
+#include <stddef.h>
+
+// Rows start on this boundary
+#define IMAGE_RING_ALIGNMENT 64
+
+// Scrolling image of width columns by height rows, in one row-major block.
+// New columns overwrite the oldest slot, so a row in display order is at
+// most two contiguous spans: slots head..width-1, then 0..head-1.
+typedef struct
+{
+    unsigned width;
+    unsigned height;
+    unsigned bytes_per_pixel;
+    size_t stride;        // bytes from one row to the next
+    unsigned head;        // slot of the oldest column, written next
+    unsigned char *data;  // aligned start of row 0
+    void *allocation;
+} image_ring_t;
+
+// Zero-filled image. Returns NULL on bad sizes or allocation failure.
+image_ring_t *image_ring_create(unsigned width, unsigned height, unsigned bytes_per_pixel);
+void image_ring_destroy(image_ring_t *ring);
+
+// Overwrite the oldest column with height pixels of bytes_per_pixel each,
+// then advance head
+void image_ring_push_column(image_ring_t *ring, const void *column);
+
+// Pixel at storage slot x, which is display column (x - head) mod width
+static inline unsigned char *image_ring_pixel(const image_ring_t *ring, unsigned x, unsigned y)
+{
+    return ring->data + y * ring->stride + (size_t)x * ring->bytes_per_pixel;
+}
+
+// Row y in display order as spans[0] and, after a wraparound, spans[1].
+// Returns the number of spans.
+typedef struct
+{
+    const unsigned char *data;
+    size_t bytes;
+} image_ring_span_t;
+
+int image_ring_row(const image_ring_t *ring, unsigned y, image_ring_span_t spans[2]);
+
+// Row y in display order into width * bytes_per_pixel bytes at out
+void image_ring_copy_row(const image_ring_t *ring, unsigned y, unsigned char *out);
+
+#endif // IMAGE_RING_H
@@ -3,116 +3,61 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
-#include <png.h>
+#include "../png_encoder/png_encoder.h"
+#include "../base64/base64.h"
 
 // Function to encode data to base64
 char *base64_encode(const unsigned char *data, size_t input_length, size_t *output_length)
 {
-    static const char encoding_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    static const char padding_char = '=';
-    *output_length = 4 * ((input_length + 2) / 3);
+    *output_length = base64_encoded_length(input_length);
 
     char *encoded_data = (char *)malloc(*output_length + 1);
     if (encoded_data == NULL)
         return NULL;
 
-    for (size_t i = 0, j = 0; i < input_length;)
-    {
-        uint32_t octet_a = i < input_length ? data[i++] : 0;
-        uint32_t octet_b = i < input_length ? data[i++] : 0;
-        uint32_t octet_c = i < input_length ? data[i++] : 0;
-
-        uint32_t triple = (octet_a << 0x10) + (octet_b << 0x08) + octet_c;
-
-        encoded_data[j++] = encoding_table[(triple >> 3 * 6) & 0x3F];
-        encoded_data[j++] = encoding_table[(triple >> 2 * 6) & 0x3F];
-        encoded_data[j++] = encoding_table[(triple >> 1 * 6) & 0x3F];
-        encoded_data[j++] = encoding_table[(triple >> 0 * 6) & 0x3F];
-    }
-
-    for (size_t i = 0; i < (input_length % 3 ? 3 - (input_length % 3) : 0); i++)
-        encoded_data[*output_length - 1 - i] = padding_char;
-
+    base64_encode_into(data, input_length, encoded_data);
     encoded_data[*output_length] = '\0';
     return encoded_data;
 }
 
-// Function to draw a blue circle on the image array
-void draw_blue_circle(unsigned char ***image, unsigned width, unsigned height, unsigned center_x, unsigned center_y, unsigned radius)
+// Function to draw a blue circle on an RGBA image
+void draw_blue_circle(image_ring_t *image, unsigned center_x, unsigned center_y, unsigned radius)
 {
-    for (unsigned y = 0; y < height; y++)
+    for (unsigned y = 0; y < image->height; y++)
     {
-        for (unsigned x = 0; x < width; x++)
+        for (unsigned x = 0; x < image->width; x++)
         {
             unsigned dx = x - center_x;
             unsigned dy = y - center_y;
             if (dx * dx + dy * dy < radius * radius)
             {
-                image[x][y][0] = 0;   // Red
-                image[x][y][1] = 0;   // Green
-                image[x][y][2] = 255; // Blue
-                image[x][y][3] = 255; // Alpha
+                unsigned char *pixel = image_ring_pixel(image, x, y);
+                pixel[0] = 0;   // Red
+                pixel[1] = 0;   // Green
+                pixel[2] = 255; // Blue
+                pixel[3] = 255; // Alpha
             }
         }
     }
 }
 
-// Function to create a PNG image from an input array of floating point values
-unsigned char *create_png_from_array(size_t *png_size, unsigned char ***image, unsigned width, unsigned height, int current_index)
+// Function to create a PNG image from an RGBA image ring, oldest column first
+unsigned char *create_png_from_ring(size_t *png_size, const image_ring_t *image)
 {
-    // Encode the image to PNG in memory using libpng
-    png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-    if (!png_ptr)
-        return NULL;
-
-    png_infop info_ptr = png_create_info_struct(png_ptr);
-    if (!info_ptr)
-    {
-        png_destroy_write_struct(&png_ptr, NULL);
-        return NULL;
-    }
-
-    if (setjmp(png_jmpbuf(png_ptr)))
-    {
-        png_destroy_write_struct(&png_ptr, &info_ptr);
-        return NULL;
-    }
-
-    unsigned char *png_data = NULL;
-    png_size_t png_data_size = 0;
-    FILE *fp = open_memstream((char **)&png_data, &png_data_size);
-    if (!fp)
-    {
-        png_destroy_write_struct(&png_ptr, &info_ptr);
+    png_encoder_t *encoder = png_encoder_create(NULL);
+    if (!encoder)
         return NULL;
-    }
 
-    png_init_io(png_ptr, fp);
-    png_set_IHDR(png_ptr, info_ptr, width, height, 8, PNG_COLOR_TYPE_RGBA, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
-    png_write_info(png_ptr, info_ptr);
-
-    // Write the image data
-    for (unsigned y = 0; y < height; ++y)
+    size_t size = 0;
+    const unsigned char *encoded = png_encoder_encode_ring(encoder, image, &size);
+    unsigned char *png_data = encoded ? (unsigned char *)malloc(size) : NULL;
+    if (png_data)
     {
-        png_bytep row = (png_bytep)malloc(4 * width * sizeof(png_byte));
-        for (unsigned x = 0; x < width; ++x)
-        {
-            int circular_index = (current_index + x) % width;
-            row[x * 4 + 0] = image[circular_index][y][0]; // Red
-            row[x * 4 + 1] = image[circular_index][y][1]; // Green
-            row[x * 4 + 2] = image[circular_index][y][2]; // Blue
-            row[x * 4 + 3] = image[circular_index][y][3]; // Alpha
-        }
-        png_write_row(png_ptr, row);
-        free(row);
+        memcpy(png_data, encoded, size);
+        *png_size = size;
     }
 
-    png_write_end(png_ptr, NULL);
-    fclose(fp);
-
-    png_destroy_write_struct(&png_ptr, &info_ptr);
-
-    *png_size = png_data_size;
+    png_encoder_destroy(encoder);
     return png_data;
 }
 
@@ -121,34 +66,18 @@ unsigned char *create_blue_circle_png(size_t *png_size, unsigned center_x, unsig
 {
     unsigned width = 256, height = 256;
 
-    // Dynamically allocate memory for the 3D array
-    unsigned char ***image = malloc(width * sizeof(unsigned char **));
-    for (unsigned i = 0; i < width; i++)
-    {
-        image[i] = malloc(height * sizeof(unsigned char *));
-        for (unsigned j = 0; j < height; j++)
-        {
-            image[i][j] = malloc(4 * sizeof(unsigned char));
-            memset(image[i][j], 255, 4 * sizeof(unsigned char)); // Initialize with white background
-        }
-    }
+    image_ring_t *image = image_ring_create(width, height, 4);
+    if (!image)
+        return NULL;
+    memset(image->data, 255, image->stride * height); // Initialize with white background
 
     // Draw a blue circle
-    draw_blue_circle(image, width, height, center_x, center_y, radius);
+    draw_blue_circle(image, center_x, center_y, radius);
 
-    // Create PNG from the image array
-    unsigned char *png_data = create_png_from_array(png_size, image, width, height, 0);
+    // Create PNG from the image
+    unsigned char *png_data = create_png_from_ring(png_size, image);
 
-    // Free the allocated memory
-    for (unsigned i = 0; i < width; i++)
-    {
-        for (unsigned j = 0; j < height; j++)
-        {
-            free(image[i][j]);
-        }
-        free(image[i]);
-    }
-    free(image);
+    image_ring_destroy(image);
 
     return png_data;
 }
\ No newline at end of file
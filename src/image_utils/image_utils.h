@@ -2,15 +2,18 @@
 #define IMAGE_UTILS_H
 
 #include <stddef.h>
+#include "../image_ring/image_ring.h"
 
-// Function to encode data to base64
+// Function to encode data to base64 in a new NUL-terminated string; see
+// base64_encode_into() to write into an existing buffer
 char *base64_encode(const unsigned char *data, size_t input_length, size_t *output_length);
 
-// Function to draw a blue circle on the image array
-void draw_blue_circle(unsigned char ***image, unsigned width, unsigned height, unsigned center_x, unsigned center_y, unsigned radius);
+// Function to draw a blue circle on an RGBA image
+void draw_blue_circle(image_ring_t *image, unsigned center_x, unsigned center_y, unsigned radius);
 
-// Function to create a PNG image from an input array of floating point values
-unsigned char *create_png_from_array(size_t *png_size, unsigned char ***image, unsigned width, unsigned height, int current_index);
+// Function to create a PNG image from an RGBA image ring, oldest column first.
+// For one-off images; a png_encoder_t avoids the setup cost per frame.
+unsigned char *create_png_from_ring(size_t *png_size, const image_ring_t *image);
 
 // Function to create a 256x256 PNG image of a blue circle in memory
 unsigned char *create_blue_circle_png(size_t *png_size, unsigned center_x, unsigned center_y, unsigned radius);
@@ -0,0 +1,99 @@
+#include "libspectrogram.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct spectrogram_handle
+{
+    spectrogram_state_t state;
+    int bins;
+    int column_size;
+};
+
+spectrogram_t *spectrogram_create(const spectrogram_config_t *config)
+{
+    // Interleaved input needs the stride the caller asked for
+    if (config->channel_count > SPECTROGRAM_MAX_CHANNELS)
+        return NULL;
+
+    spectrogram_t *handle = (spectrogram_t *)calloc(1, sizeof(spectrogram_t));
+    if (!handle)
+        return NULL;
+
+    // Block input carries only the transformed axes
+    spectrogram_config_t block_config = *config;
+    block_config.channel = 0;
+    if (!init_spectrogram_state_with_config(&handle->state, &block_config))
+    {
+        free(handle);
+        return NULL;
+    }
+
+    handle->bins = handle->state.window_size / 2;
+    handle->column_size = handle->state.channel_count * handle->bins;
+    if (handle->state.magnitude_spectrogram)
+    {
+        handle->column_size += handle->bins;
+    }
+    return handle;
+}
+
+void spectrogram_destroy(spectrogram_t *handle)
+{
+    if (!handle)
+        return;
+    free_spectrogram_state(&handle->state);
+    free(handle);
+}
+
+int spectrogram_column_size(const spectrogram_t *handle)
+{
+    return handle->column_size;
+}
+
+int spectrogram_columns_for(const spectrogram_t *handle, int n)
+{
+    const spectrogram_state_t *state = &handle->state;
+    int hops = n;
+    if (state->mode != SPECTROGRAM_MODE_SLIDING_DFT)
+    {
+        hops = n < state->samples_until_column ? 0 : 1 + (n - state->samples_until_column) / state->hop_size;
+    }
+    if (state->average == SPECTROGRAM_AVERAGE_NONE)
+        return hops;
+    return hops < state->hops_until_average ? 0 : 1 + (hops - state->hops_until_average) / state->average_count;
+}
+
+static void copy_column(const spectrogram_t *handle, nst_real_t *out)
+{
+    const spectrogram_state_t *state = &handle->state;
+    size_t bytes = handle->bins * sizeof(nst_real_t);
+    for (int c = 0; c < state->channel_count; c++)
+    {
+        memcpy(out, state->channel_spectrograms[c], bytes);
+        out += handle->bins;
+    }
+    if (state->magnitude_spectrogram)
+    {
+        memcpy(out, state->magnitude_spectrogram, bytes);
+    }
+}
+
+int spectrogram_process_block(spectrogram_t *handle, const nst_real_t *samples, int n,
+                              nst_real_t *out_columns, int max_cols)
+{
+    if (spectrogram_columns_for(handle, n) > max_cols)
+        return -1;
+
+    spectrogram_state_t *state = &handle->state;
+    int channel_count = state->channel_count;
+    int columns = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (algorithm_update_frame(state, samples + (size_t)i * channel_count))
+        {
+            copy_column(handle, out_columns + (size_t)columns * handle->column_size);
+            columns++;
+        }
+    }
+    return columns;
+}
@@ -0,0 +1,43 @@
+#ifndef LIBSPECTROGRAM_H
+#define LIBSPECTROGRAM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "../nst_main.h"
+
+// Block-processing spectrogram engine. Each handle owns all of its state, so
+// independent handles can run concurrently on different threads; a single
+// handle must not be used from two threads at once.
+typedef struct spectrogram_handle spectrogram_t;
+
+// Returns NULL for an unusable config or on allocation failure. The config is
+// copied; Goertzel frequencies need not outlive the call.
+spectrogram_t *spectrogram_create(const spectrogram_config_t *config);
+void spectrogram_destroy(spectrogram_t *handle);
+
+// Values in one output column: window_size / 2 bins for each of the
+// channel_count axes in order, followed by the window_size / 2 bins of the
+// axis vector magnitude when config->magnitude_vector is set. Values are
+// magnitudes, or power with config->power_columns. Averaging always
+// averages power and converts the result back to those units.
+int spectrogram_column_size(const spectrogram_t *handle);
+
+// Number of columns the next n sample frames will complete
+int spectrogram_columns_for(const spectrogram_t *handle, int n);
+
+// Process n sample frames of channel_count interleaved axis values
+// (samples[i * channel_count + c]) and write every completed column to
+// out_columns, spectrogram_column_size() values each. Returns the number of
+// columns written, or -1 without consuming anything if that would exceed
+// max_cols.
+int spectrogram_process_block(spectrogram_t *handle, const nst_real_t *samples, int n,
+                              nst_real_t *out_columns, int max_cols);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBSPECTROGRAM_H
@@ -0,0 +1,29 @@
+#include "log.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+int nst_log_level = NST_LOG_LEVEL_INFO;
+
+static const char *const level_names[] = {"off", "error", "warn", "info", "debug", "trace"};
+
+int nst_log_level_from_name(const char *name, int *level)
+{
+    for (int i = 0; i < (int)(sizeof(level_names) / sizeof(level_names[0])); i++)
+    {
+        if (strcmp(name, level_names[i]) == 0)
+        {
+            *level = i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void nst_log_write(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
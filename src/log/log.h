@@ -0,0 +1,61 @@
+#ifndef LOG_H
+#define LOG_H
+
+// Leveled logging to stderr. A message is written when its level is at or
+// below both the compile-time ceiling NST_LOG_MAX_LEVEL and the runtime
+// level. Levels above the ceiling compile to nothing, arguments included,
+// so per-sample and per-frame traces cost nothing in a normal build.
+typedef enum
+{
+    NST_LOG_LEVEL_OFF,
+    NST_LOG_LEVEL_ERROR,
+    NST_LOG_LEVEL_WARN,
+    NST_LOG_LEVEL_INFO,
+    NST_LOG_LEVEL_DEBUG, // a line per output frame
+    NST_LOG_LEVEL_TRACE, // bulk data: spectrum bins, pixels, encoded images
+} nst_log_level_t;
+
+#ifndef NST_LOG_MAX_LEVEL
+#define NST_LOG_MAX_LEVEL NST_LOG_LEVEL_INFO
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Runtime level, NST_LOG_LEVEL_INFO by default
+extern int nst_log_level;
+
+// Parse "off", "error", "warn", "info", "debug" or "trace". Returns 0 for an
+// unknown name.
+int nst_log_level_from_name(const char *name, int *level);
+
+void nst_log_write(const char *format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 1, 2)))
+#endif
+    ;
+
+#ifdef __cplusplus
+}
+#endif
+
+// True when messages of this level are written; guards loops that only
+// build a trace
+#define NST_LOG_ENABLED(level) ((level) <= NST_LOG_MAX_LEVEL && (level) <= nst_log_level)
+
+#define NST_LOG(level, ...)             \
+    do                                  \
+    {                                   \
+        if (NST_LOG_ENABLED(level))     \
+            nst_log_write(__VA_ARGS__); \
+    } while (0)
+
+#define NST_LOG_ERROR(...) NST_LOG(NST_LOG_LEVEL_ERROR, __VA_ARGS__)
+#define NST_LOG_WARN(...) NST_LOG(NST_LOG_LEVEL_WARN, __VA_ARGS__)
+#define NST_LOG_INFO(...) NST_LOG(NST_LOG_LEVEL_INFO, __VA_ARGS__)
+#define NST_LOG_DEBUG(...) NST_LOG(NST_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define NST_LOG_TRACE(...) NST_LOG(NST_LOG_LEVEL_TRACE, __VA_ARGS__)
+
+#endif // LOG_H
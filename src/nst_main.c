@@ -1,7 +1,9 @@
 #include <stdio.h>
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 #include "nst_main.h"
+#include "log/log.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -39,100 +41,753 @@ complex_t complex_exp(double theta)
     return result;
 }
 
-double complex_abs(complex_t a)
+nst_real_t complex_abs(complex_t a)
 {
-    return sqrt(a.real * a.real + a.imag * a.imag);
+    return NST_SQRT(a.real * a.real + a.imag * a.imag);
 }
 
-void fft(complex_t *X, int N)
+// Column values are |X| or, with power_columns, |X|^2
+static inline nst_real_t column_from_power(const spectrogram_state_t *state, nst_real_t power)
 {
-    if (N <= 1)
-        return;
+    return state->power_columns ? power : NST_SQRT(power);
+}
 
-    complex_t even[N / 2];
-    complex_t odd[N / 2];
+static inline nst_real_t column_to_power(const spectrogram_state_t *state, nst_real_t value)
+{
+    return state->power_columns ? value : value * value;
+}
 
-    for (int i = 0; i < N / 2; i++)
+void spectrogram_config_default(spectrogram_config_t *config, int window_size)
+{
+    config->window_size = window_size;
+    config->hop_size = 0;
+    config->overlap = 0.5;
+    config->channel = 0;
+    config->channel_count = 1;
+    config->magnitude_vector = 0;
+    config->mode = SPECTROGRAM_MODE_FFT;
+    config->resync_interval = 0;
+    config->sample_rate = 1.0;
+    config->goertzel_frequencies = NULL;
+    config->goertzel_count = 0;
+    config->window = WINDOW_RECTANGULAR;
+    config->kaiser_beta = 8.6;
+    config->average = SPECTROGRAM_AVERAGE_NONE;
+    config->average_count = 8;
+    config->ema_alpha = 0.0;
+    config->power_columns = 0;
+}
+
+void init_spectrogram_state(spectrogram_state_t *state, int window_size)
+{
+    spectrogram_config_t config;
+    spectrogram_config_default(&config, window_size);
+    init_spectrogram_state_with_config(state, &config);
+}
+
+// Sum of squared window weights, the energy normalization of the PSD
+static double window_energy(const spectrogram_config_t *config)
+{
+    const nst_real_t *w = window_acquire(config->window, config->window_size, config->kaiser_beta);
+    if (!w || (config->mode == SPECTROGRAM_MODE_SLIDING_DFT && config->window == WINDOW_KAISER))
     {
-        even[i] = X[i * 2];
-        odd[i] = X[i * 2 + 1];
+        window_release(w);
+        return config->window_size;
     }
 
-    fft(even, N / 2);
-    fft(odd, N / 2);
+    double energy = 0.0;
+    for (int i = 0; i < config->window_size; i++)
+    {
+        energy += (double)w[i] * w[i];
+    }
+    window_release(w);
+    return energy;
+}
+
+static void init_averaging(spectrogram_state_t *state, const spectrogram_config_t *config)
+{
+    int bins = state->window_size / 2;
+    int count = config->average_count > 0 ? config->average_count : 1;
 
-    for (int k = 0; k < N / 2; k++)
+    state->average = config->average;
+    state->average_count = count;
+    state->hops_until_average = count;
+    state->ema_alpha = (nst_real_t)(config->ema_alpha > 0 ? config->ema_alpha : 2.0 / (count + 1));
+    state->psd_scale = (nst_real_t)(2.0 / (config->sample_rate * window_energy(config)));
+    for (int c = 0; c < state->channel_count; c++)
     {
-        complex_t t = complex_mul(complex_exp(-2 * M_PI * k / N), odd[k]);
-        X[k] = complex_add(even[k], t);
-        X[k + N / 2] = complex_sub(even[k], t);
+        state->average_power[c] = (nst_real_t *)calloc(bins, sizeof(nst_real_t));
+        state->power_spectrograms[c] = (nst_real_t *)calloc(bins, sizeof(nst_real_t));
     }
 }
 
-void init_spectrogram_state(spectrogram_state_t *state, int window_size)
+// Every buffer the configured mode uses was allocated
+static int state_allocated(const spectrogram_state_t *state, const spectrogram_config_t *config)
+{
+    if (!state->plan || (config->magnitude_vector && !state->magnitude_spectrogram))
+        return 0;
+    if (config->window != WINDOW_RECTANGULAR && state->mode != SPECTROGRAM_MODE_SLIDING_DFT && !state->window)
+        return 0;
+    for (int c = 0; c < state->channel_count; c++)
+    {
+        if (!state->rings[c].data || !state->channel_spectrograms[c] || !state->frames[c] || !state->fft_buffers[c])
+            return 0;
+    }
+    if (state->mode == SPECTROGRAM_MODE_SLIDING_DFT &&
+        (!state->sdft_real || !state->sdft_imag || !state->sdft_cos || !state->sdft_sin ||
+         (state->sdft_taps > 0 && !state->sdft_padded)))
+        return 0;
+    if (state->goertzel_count > 0 &&
+        (!state->goertzel_coeff || !state->goertzel_bins || !state->goertzel_s1 || !state->goertzel_s2))
+        return 0;
+    for (int c = 0; c < state->channel_count && state->average != SPECTROGRAM_AVERAGE_NONE; c++)
+    {
+        if (!state->average_power[c] || !state->power_spectrograms[c])
+            return 0;
+    }
+    return 1;
+}
+
+// hop_size, or the hop that gives the configured overlap
+static int config_hop_size(const spectrogram_config_t *config)
 {
-    state->buffer_index = 0;
+    int hop_size = config->hop_size;
+    if (hop_size <= 0)
+    {
+        hop_size = config->window_size - (int)lround(config->overlap * config->window_size);
+    }
+    return hop_size < 1 ? 1 : hop_size;
+}
+
+// At least one target, all between DC and Nyquist; a higher one would alias
+// into the rows below it
+static int goertzel_config_valid(const spectrogram_config_t *config)
+{
+    if (config->goertzel_count < 1 || !config->goertzel_frequencies || !(config->sample_rate > 0))
+        return 0;
+    for (int k = 0; k < config->goertzel_count; k++)
+    {
+        double f = config->goertzel_frequencies[k];
+        if (!(f >= 0 && f <= 0.5 * config->sample_rate))
+            return 0;
+    }
+    return 1;
+}
+
+int init_spectrogram_state_with_config(spectrogram_state_t *state, const spectrogram_config_t *config)
+{
+    memset(state, 0, sizeof(*state));
+    if (config->window_size < 2)
+        return 0;
+    if (config->channel < 0 || config->channel >= NST_EVENT_MAX_VALUES_COUNT)
+        return 0;
+    if (config->mode == SPECTROGRAM_MODE_GOERTZEL && !goertzel_config_valid(config))
+        return 0;
+
+    int window_size = config->window_size;
+    int bins = window_size / 2;
+    int channel_count = config->channel_count;
+    if (channel_count < 1)
+    {
+        channel_count = 1;
+    }
+    if (channel_count > SPECTROGRAM_MAX_CHANNELS)
+    {
+        channel_count = SPECTROGRAM_MAX_CHANNELS;
+    }
+    if (config->channel + channel_count > NST_EVENT_MAX_VALUES_COUNT)
+    {
+        channel_count = NST_EVENT_MAX_VALUES_COUNT - config->channel;
+    }
+
+    int hop_size = config_hop_size(config);
+    if (config->mode == SPECTROGRAM_MODE_SLIDING_DFT)
+    {
+        hop_size = 1;
+    }
+
     state->window_size = window_size;
-    state->buffer = (nst_event_t *)malloc(window_size * sizeof(nst_event_t));
-    state->spectrogram = (double *)malloc((window_size / 2) * sizeof(double));
-    state->window = (double *)malloc(window_size * sizeof(double));
+    state->hop_size = hop_size;
+    state->samples_until_column = hop_size;
+    state->channel = config->channel;
+    state->channel_count = channel_count;
+    state->mode = config->mode;
+    state->power_columns = config->power_columns;
+    state->plan = rfft_plan_create(window_size);
+
+    for (int c = 0; c < channel_count; c++)
+    {
+        // One extra slot keeps the sample leaving the window for the sliding DFT
+        ring_buffer_init(&state->rings[c], window_size + 1);
+        state->channel_spectrograms[c] = (nst_real_t *)calloc(bins, sizeof(nst_real_t));
+        state->frames[c] = (nst_real_t *)malloc(window_size * sizeof(nst_real_t));
+        state->fft_buffers[c] = (complex_t *)malloc((bins + 1) * sizeof(complex_t));
+    }
+    state->spectrogram = state->channel_spectrograms[0];
+    if (config->magnitude_vector)
+    {
+        state->magnitude_spectrogram = (nst_real_t *)calloc(bins, sizeof(nst_real_t));
+    }
 
-    memset(state->buffer, 0, window_size * sizeof(nst_event_t));
-    memset(state->spectrogram, 0, (window_size / 2) * sizeof(double));
+    if (state->mode == SPECTROGRAM_MODE_SLIDING_DFT)
+    {
+        // Bin window_size / 2 is tracked too, the window kernel reaches it
+        int tracked = bins + 1;
+        state->sdft_real = (nst_real_t *)calloc(channel_count * tracked, sizeof(nst_real_t));
+        state->sdft_imag = (nst_real_t *)calloc(channel_count * tracked, sizeof(nst_real_t));
+        state->sdft_cos = (nst_real_t *)malloc(tracked * sizeof(nst_real_t));
+        state->sdft_sin = (nst_real_t *)malloc(tracked * sizeof(nst_real_t));
+        for (int k = 0; k < tracked && state->sdft_cos && state->sdft_sin; k++)
+        {
+            state->sdft_cos[k] = cos(2 * M_PI * k / window_size);
+            state->sdft_sin[k] = sin(2 * M_PI * k / window_size);
+        }
 
-    // Apply windowing function (Hann window)
-    for (int i = 0; i < window_size; i++)
+        // Kaiser is not a short cosine sum and falls back to rectangular here
+        double terms[WINDOW_MAX_COSINE_TERMS];
+        int taps = config->window == WINDOW_RECTANGULAR ? 0 : window_cosine_terms(config->window, terms);
+        if (taps > 0)
+        {
+            // w[n] = sum_j (-1)^j a_j cos(2*pi*j*n/N) convolves X with
+            // a_0 at offset 0 and (-1)^j a_j / 2 at offsets +-j
+            double sign = 1.0;
+            for (int j = 0; j < taps; j++)
+            {
+                state->sdft_kernel[j] = (nst_real_t)(sign * terms[j] / 2);
+                sign = -sign;
+            }
+            state->sdft_taps = taps;
+            state->sdft_padded = (complex_t *)malloc((bins + 2 * (taps - 1)) * sizeof(complex_t));
+        }
+    }
+    else
+    {
+        state->window = window_acquire(config->window, window_size, config->kaiser_beta);
+    }
+
+    if (state->mode == SPECTROGRAM_MODE_GOERTZEL && config->goertzel_count > 0)
     {
-        state->window[i] = 0.5 * (1 - cos(2 * M_PI * i / (window_size - 1)));
+        int count = config->goertzel_count;
+        state->goertzel_count = count;
+        state->goertzel_coeff = (nst_real_t *)malloc(count * sizeof(nst_real_t));
+        state->goertzel_bins = (int *)malloc(count * sizeof(int));
+        state->goertzel_s1 = (nst_real_t *)malloc(count * sizeof(nst_real_t));
+        state->goertzel_s2 = (nst_real_t *)malloc(count * sizeof(nst_real_t));
+        for (int k = 0; k < count && state->goertzel_coeff && state->goertzel_bins; k++)
+        {
+            // Fractional bin positions are fine; only the output row is rounded
+            double bin = config->goertzel_frequencies[k] / config->sample_rate * window_size;
+            int row = (int)lround(bin);
+            state->goertzel_coeff[k] = 2 * cos(2 * M_PI * bin / window_size);
+            state->goertzel_bins[k] = row < 0 ? 0 : (row >= bins ? bins - 1 : row);
+        }
     }
+
+    // Rounding in the recursive update drifts slowly; an exact FFT every
+    // resync_interval samples bounds it
+    state->resync_interval = config->resync_interval > 0 ? config->resync_interval : 64 * window_size;
+    state->samples_until_resync = state->resync_interval;
+
+    if (config->average != SPECTROGRAM_AVERAGE_NONE)
+    {
+        init_averaging(state, config);
+    }
+
+    if (!state_allocated(state, config))
+    {
+        free_spectrogram_state(state);
+        return 0;
+    }
+    return 1;
 }
 
-void algorithm_update(spectrogram_state_t *state, const nst_event_t *input_event)
+void free_spectrogram_state(spectrogram_state_t *state)
 {
-    // Add new event to buffer
-    state->buffer[state->buffer_index++] = *input_event;
+    for (int c = 0; c < state->channel_count; c++)
+    {
+        ring_buffer_free(&state->rings[c]);
+        free(state->channel_spectrograms[c]);
+        free(state->frames[c]);
+        free(state->fft_buffers[c]);
+        free(state->average_power[c]);
+        free(state->power_spectrograms[c]);
+    }
+    free(state->magnitude_spectrogram);
+    window_release(state->window);
+    rfft_plan_destroy(state->plan);
+    free(state->sdft_real);
+    free(state->sdft_imag);
+    free(state->sdft_cos);
+    free(state->sdft_sin);
+    free(state->sdft_padded);
+    free(state->goertzel_coeff);
+    free(state->goertzel_bins);
+    free(state->goertzel_s1);
+    free(state->goertzel_s2);
+    memset(state, 0, sizeof(*state));
+}
 
+// Transform the latest window of every axis in one batched pass, weighting
+// the samples as they are gathered from the rings (NULL weights: rectangular)
+static void fft_columns(spectrogram_state_t *state, const nst_real_t *weights)
+{
     int window_size = state->window_size;
-    complex_t X[window_size];
+    int channel_count = state->channel_count;
 
-    // Approach 1: Without Windowing (Rectangular Window)
-    for (int i = 0; i < window_size; i++)
+    for (int c = 0; c < channel_count; c++)
     {
-        X[i].real = state->buffer[i].values[0];
-        X[i].imag = 0.0;
+        ring_buffer_copy_window_weighted(&state->rings[c], window_size, weights, state->frames[c]);
     }
 
-    // Uncomment the following block for Approach 2: With Windowing (Hann Window)
-    /*
-    for (int i = 0; i < window_size; i++) {
-        X[i].real = state->buffer[i].values[0] * state->window[i]; // Apply Hann window
-        X[i].imag = 0.0;
+    // Compute FFT of the real input
+    rfft_execute_batch(state->plan, (const nst_real_t *const *)state->frames, state->fft_buffers, channel_count);
+}
+
+// Store bin magnitudes of every axis from state->fft_buffers
+static void store_fft_magnitudes(spectrogram_state_t *state)
+{
+    int bins = state->window_size / 2;
+    for (int c = 0; c < state->channel_count; c++)
+    {
+        const complex_t *X = state->fft_buffers[c];
+        nst_real_t *column = state->channel_spectrograms[c];
+        if (state->power_columns)
+        {
+            for (int i = 0; i < bins; i++)
+            {
+                column[i] = X[i].real * X[i].real + X[i].imag * X[i].imag;
+            }
+            continue;
+        }
+        for (int i = 0; i < bins; i++)
+        {
+            column[i] = complex_abs(X[i]);
+        }
     }
-    */
+}
 
-    // Compute FFT
-    fft(X, window_size);
+// Bin k of a real signal's DFT from the tracked bins 0..window_size / 2,
+// for any k, by periodicity and conjugate symmetry
+static complex_t sdft_bin(const spectrogram_state_t *state, const nst_real_t *re, const nst_real_t *im, int k)
+{
+    int window_size = state->window_size;
+    k %= window_size;
+    if (k < 0)
+    {
+        k += window_size;
+    }
+
+    complex_t bin;
+    if (k <= window_size / 2)
+    {
+        bin.real = re[k];
+        bin.imag = im[k];
+    }
+    else
+    {
+        bin.real = re[window_size - k];
+        bin.imag = -im[window_size - k];
+    }
+    return bin;
+}
+
+// Magnitudes of one axis after the frequency-domain window kernel
+static void sdft_windowed_magnitudes(spectrogram_state_t *state, const nst_real_t *re, const nst_real_t *im, nst_real_t *out)
+{
+    int bins = state->window_size / 2;
+    int reach = state->sdft_taps - 1;
+    const nst_real_t *kernel = state->sdft_kernel;
+
+    // Extend the spectrum by reach bins on both sides so the kernel loop
+    // has no edge cases; P[k] is bin k - reach
+    complex_t *P = state->sdft_padded;
+    for (int k = -reach; k < bins + reach; k++)
+    {
+        P[k + reach] = sdft_bin(state, re, im, k);
+    }
 
-    // Store magnitude of FFT results
-    for (int i = 0; i < window_size / 2; i++)
+    for (int k = 0; k < bins; k++)
     {
-        state->spectrogram[i] = complex_abs(X[i]);
+        const complex_t *center = P + k + reach;
+        nst_real_t r = 0;
+        nst_real_t i = 0;
+        for (int j = 0; j <= reach; j++)
+        {
+            r += kernel[j] * (center[-j].real + center[j].real);
+            i += kernel[j] * (center[-j].imag + center[j].imag);
+        }
+        out[k] = column_from_power(state, r * r + i * i);
     }
+}
+
+// S[k] = (S[k] + x_new - x_old) * exp(2*pi*i*k/N) keeps S equal to the DFT
+// of the latest window, indexed from its oldest sample
+static void sliding_dft_columns(spectrogram_state_t *state)
+{
+    int window_size = state->window_size;
+    int bins = window_size / 2;
+    int tracked = bins + 1;
 
-    // Output the spectrogram data (for simplicity, we just print it here)
-    printf("Spectrogram:\n");
-    for (int i = 0; i < window_size / 2; i++)
+    if (--state->samples_until_resync <= 0)
     {
-        printf("%f ", state->spectrogram[i]);
+        // The recursion tracks the unwindowed spectrum
+        state->samples_until_resync = state->resync_interval;
+        fft_columns(state, NULL);
+        for (int c = 0; c < state->channel_count; c++)
+        {
+            for (int k = 0; k < tracked; k++)
+            {
+                state->sdft_real[c * tracked + k] = state->fft_buffers[c][k].real;
+                state->sdft_imag[c * tracked + k] = state->fft_buffers[c][k].imag;
+            }
+        }
+    }
+    else
+    {
+        const nst_real_t *cs = state->sdft_cos;
+        const nst_real_t *sn = state->sdft_sin;
+        for (int c = 0; c < state->channel_count; c++)
+        {
+            const ring_buffer_t *ring = &state->rings[c];
+            nst_real_t delta = ring_buffer_sample(ring, 0) - ring_buffer_sample(ring, window_size);
+            nst_real_t *re = state->sdft_real + c * tracked;
+            nst_real_t *im = state->sdft_imag + c * tracked;
+
+            for (int k = 0; k < tracked; k++)
+            {
+                nst_real_t r = re[k] + delta;
+                nst_real_t i = im[k];
+                re[k] = r * cs[k] - i * sn[k];
+                im[k] = r * sn[k] + i * cs[k];
+            }
+        }
     }
-    printf("\n");
 
-    // Shift buffer to remove processed data
-    int shift_amount = window_size / 2;
-    if (state->buffer_index >= shift_amount)
+    for (int c = 0; c < state->channel_count; c++)
+    {
+        const nst_real_t *re = state->sdft_real + c * tracked;
+        const nst_real_t *im = state->sdft_imag + c * tracked;
+        nst_real_t *out = state->channel_spectrograms[c];
+
+        if (state->sdft_padded)
+        {
+            sdft_windowed_magnitudes(state, re, im, out);
+            continue;
+        }
+        for (int k = 0; k < bins; k++)
+        {
+            out[k] = column_from_power(state, re[k] * re[k] + im[k] * im[k]);
+        }
+    }
+}
+
+// Run every Goertzel filter across the latest window. The filters are
+// independent, so the inner loop steps all of them for one sample.
+static void goertzel_columns(spectrogram_state_t *state)
+{
+    int window_size = state->window_size;
+    int count = state->goertzel_count;
+    const nst_real_t *coeff = state->goertzel_coeff;
+    nst_real_t *s1 = state->goertzel_s1;
+    nst_real_t *s2 = state->goertzel_s2;
+
+    for (int c = 0; c < state->channel_count; c++)
+    {
+        nst_real_t *x = state->frames[c];
+        ring_buffer_copy_window_weighted(&state->rings[c], window_size, state->window, x);
+
+        for (int k = 0; k < count; k++)
+        {
+            s1[k] = 0;
+            s2[k] = 0;
+        }
+
+        for (int n = 0; n < window_size; n++)
+        {
+            nst_real_t sample = x[n];
+            for (int k = 0; k < count; k++)
+            {
+                nst_real_t s0 = sample + coeff[k] * s1[k] - s2[k];
+                s2[k] = s1[k];
+                s1[k] = s0;
+            }
+        }
+
+        for (int k = 0; k < count; k++)
+        {
+            nst_real_t power = s1[k] * s1[k] + s2[k] * s2[k] - coeff[k] * s1[k] * s2[k];
+            state->channel_spectrograms[c][state->goertzel_bins[k]] = column_from_power(state, power > 0 ? power : 0);
+        }
+    }
+}
+
+// Fold the power of the hop just computed into the running average.
+// Returns 1 when average_count hops have been folded in, after replacing
+// channel_spectrograms with the averaged column.
+static int average_columns(spectrogram_state_t *state)
+{
+    int bins = state->window_size / 2;
+    int first = state->hops_until_average == state->average_count;
+
+    for (int c = 0; c < state->channel_count; c++)
+    {
+        const nst_real_t *column = state->channel_spectrograms[c];
+        nst_real_t *acc = state->average_power[c];
+
+        switch (state->average)
+        {
+        case SPECTROGRAM_AVERAGE_WELCH:
+            for (int k = 0; k < bins; k++)
+            {
+                nst_real_t power = column_to_power(state, column[k]);
+                acc[k] = first ? power : acc[k] + power;
+            }
+            break;
+        case SPECTROGRAM_AVERAGE_EMA:
+        {
+            // The first hop seeds the average instead of decaying from zero
+            nst_real_t alpha = state->ema_primed ? state->ema_alpha : 1;
+            for (int k = 0; k < bins; k++)
+            {
+                acc[k] += alpha * (column_to_power(state, column[k]) - acc[k]);
+            }
+            break;
+        }
+        case SPECTROGRAM_AVERAGE_MAX_HOLD:
+            for (int k = 0; k < bins; k++)
+            {
+                nst_real_t power = column_to_power(state, column[k]);
+                acc[k] = first || power > acc[k] ? power : acc[k];
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    state->ema_primed = 1;
+
+    if (--state->hops_until_average > 0)
+    {
+        return 0;
+    }
+    state->hops_until_average = state->average_count;
+
+    nst_real_t mean = state->average == SPECTROGRAM_AVERAGE_WELCH ? (nst_real_t)1 / state->average_count : 1;
+    for (int c = 0; c < state->channel_count; c++)
+    {
+        const nst_real_t *acc = state->average_power[c];
+        nst_real_t *column = state->channel_spectrograms[c];
+        nst_real_t *psd = state->power_spectrograms[c];
+        for (int k = 0; k < bins; k++)
+        {
+            nst_real_t power = acc[k] * mean;
+            column[k] = column_from_power(state, power);
+            psd[k] = power * state->psd_scale;
+        }
+        // DC has no negative-frequency twin to fold in
+        psd[0] *= (nst_real_t)0.5;
+    }
+    return 1;
+}
+
+// |v|[k] = sqrt(sum over axes of |X_c[k]|^2), or its square with power columns
+static void magnitude_vector_column(spectrogram_state_t *state)
+{
+    int bins = state->window_size / 2;
+    nst_real_t *out = state->magnitude_spectrogram;
+
+    for (int k = 0; k < bins; k++)
+    {
+        out[k] = 0;
+    }
+    for (int c = 0; c < state->channel_count; c++)
+    {
+        const nst_real_t *column = state->channel_spectrograms[c];
+        for (int k = 0; k < bins; k++)
+        {
+            out[k] += column_to_power(state, column[k]);
+        }
+    }
+    for (int k = 0; k < bins; k++)
+    {
+        out[k] = column_from_power(state, out[k]);
+    }
+}
+
+int algorithm_update(spectrogram_state_t *state, const nst_event_t *input_event)
+{
+    nst_real_t frame[SPECTROGRAM_MAX_CHANNELS];
+    for (int c = 0; c < state->channel_count; c++)
+    {
+        frame[c] = (nst_real_t)input_event->values[state->channel + c];
+    }
+    return algorithm_update_frame(state, frame);
+}
+
+int algorithm_update_frame(spectrogram_state_t *state, const nst_real_t *frame)
+{
+    // Add new samples to the rings
+    for (int c = 0; c < state->channel_count; c++)
+    {
+        ring_buffer_push(&state->rings[c], frame[c]);
+    }
+
+    if (state->mode == SPECTROGRAM_MODE_SLIDING_DFT)
+    {
+        sliding_dft_columns(state);
+    }
+    else
+    {
+        // Only transform once hop_size new samples have arrived
+        if (--state->samples_until_column > 0)
+        {
+            return 0;
+        }
+        state->samples_until_column = state->hop_size;
+        if (state->mode == SPECTROGRAM_MODE_GOERTZEL)
+        {
+            goertzel_columns(state);
+        }
+        else
+        {
+            fft_columns(state, state->window);
+            store_fft_magnitudes(state);
+        }
+    }
+
+    if (state->average != SPECTROGRAM_AVERAGE_NONE && !average_columns(state))
+    {
+        return 0;
+    }
+
+    if (state->magnitude_spectrogram)
+    {
+        magnitude_vector_column(state);
+    }
+
+    if (NST_LOG_ENABLED(NST_LOG_LEVEL_TRACE))
+    {
+        nst_log_write("Spectrogram:\n");
+        for (int i = 0; i < state->window_size / 2; i++)
+        {
+            nst_log_write("%f ", state->spectrogram[i]);
+        }
+        nst_log_write("\n");
+    }
+
+    return 1;
+}
+
+int init_spectrogram_fixed_state(spectrogram_fixed_state_t *state, const spectrogram_config_t *config)
+{
+    memset(state, 0, sizeof(*state));
+
+    // Only the plain single-axis FFT column has an integer implementation
+    if (config->mode != SPECTROGRAM_MODE_FFT || config->channel_count != 1 || config->magnitude_vector ||
+        config->average != SPECTROGRAM_AVERAGE_NONE)
+    {
+        return 0;
+    }
+
+    int window_size = config->window_size;
+    int bins = window_size / 2;
+    state->plan = rfft_fixed_plan_create(window_size);
+    if (!state->plan)
+        return 0;
+
+    state->power_columns = config->power_columns;
+    if (config->window != WINDOW_RECTANGULAR)
+    {
+        const nst_real_t *w = window_acquire(config->window, window_size, config->kaiser_beta);
+        state->window = (int16_t *)malloc(window_size * sizeof(int16_t));
+        if (!w || !state->window)
+        {
+            window_release(w);
+            free_spectrogram_fixed_state(state);
+            return 0;
+        }
+        for (int i = 0; i < window_size; i++)
+        {
+            long q = lrint(w[i] * 32768.0);
+            state->window[i] = (int16_t)(q > INT16_MAX ? INT16_MAX : (q < INT16_MIN ? INT16_MIN : q));
+        }
+        window_release(w);
+    }
+
+    state->window_size = window_size;
+    state->hop_size = config_hop_size(config);
+    state->samples_until_column = state->hop_size;
+    state->samples = (int32_t *)calloc(window_size, sizeof(int32_t));
+    state->sample_mask = window_size - 1;
+    state->frame = (int32_t *)malloc(window_size * sizeof(int32_t));
+    state->fft_buffer = (complex_q31_t *)malloc((bins + 1) * sizeof(complex_q31_t));
+    state->spectrogram = (uint32_t *)calloc(bins, sizeof(uint32_t));
+    if (!state->samples || !state->frame || !state->fft_buffer || !state->spectrogram)
+    {
+        free_spectrogram_fixed_state(state);
+        return 0;
+    }
+    return 1;
+}
+
+void free_spectrogram_fixed_state(spectrogram_fixed_state_t *state)
+{
+    rfft_fixed_plan_destroy(state->plan);
+    free(state->window);
+    free(state->samples);
+    free(state->frame);
+    free(state->fft_buffer);
+    free(state->spectrogram);
+    memset(state, 0, sizeof(*state));
+}
+
+int algorithm_update_q31(spectrogram_fixed_state_t *state, int32_t sample)
+{
+    state->samples[state->sample_count & state->sample_mask] = sample;
+    state->sample_count++;
+
+    if (--state->samples_until_column > 0)
+    {
+        return 0;
+    }
+    state->samples_until_column = state->hop_size;
+
+    // The ring holds exactly one window, so the oldest sample is the next slot
+    int window_size = state->window_size;
+    int start = (int)(state->sample_count & state->sample_mask);
+    for (int i = 0; i < window_size; i++)
+    {
+        state->frame[i] = state->samples[(start + i) & state->sample_mask];
+    }
+    if (state->window)
+    {
+        for (int i = 0; i < window_size; i++)
+        {
+            state->frame[i] = (int32_t)(((int64_t)state->frame[i] * state->window[i]) >> 15);
+        }
+    }
+
+    state->exponent = rfft_fixed_execute(state->plan, state->frame, state->fft_buffer);
+    for (int k = 0; k < window_size / 2; k++)
+    {
+        state->spectrogram[k] = complex_q31_magnitude(state->fft_buffer[k]);
+    }
+    return 1;
+}
+
+int algorithm_update_q15(spectrogram_fixed_state_t *state, int16_t sample)
+{
+    return algorithm_update_q31(state, (int32_t)((uint32_t)(uint16_t)sample << 16));
+}
+
+void spectrogram_fixed_column(const spectrogram_fixed_state_t *state, nst_real_t full_scale, nst_real_t *out)
+{
+    // Q31 full scale is 2^31
+    nst_real_t scale = (nst_real_t)ldexp(full_scale, state->exponent - 31);
+    for (int k = 0; k < state->window_size / 2; k++)
     {
-        memmove(state->buffer, state->buffer + shift_amount, (state->buffer_index - shift_amount) * sizeof(nst_event_t));
-        state->buffer_index -= shift_amount;
+        nst_real_t magnitude = (nst_real_t)state->spectrogram[k] * scale;
+        out[k] = state->power_columns ? magnitude * magnitude : magnitude;
     }
 }
 
@@ -149,9 +804,7 @@ void algorithm_update(spectrogram_state_t *state, const nst_event_t *input_event
 //     }
 
 //     // Free allocated memory
-//     free(state.buffer);
-//     free(state.spectrogram);
-//     free(state.window);
+//     free_spectrogram_state(&state);
 
 //     return 0;
 // }
\ No newline at end of file
@@ -2,33 +2,174 @@
 #define NST_MAIN_H
 
 #include "nst_types.h"
+#include "fft/fft.h"
+#include "fft/fft_fixed.h"
+#include "ring_buffer/ring_buffer.h"
+#include "window/window.h"
 
 #define WINDOW_SIZE 256
-
-typedef struct
-{
-    double real;
-    double imag;
-} complex_t;
+#define SPECTROGRAM_MAX_CHANNELS 4
 
 complex_t complex_add(complex_t a, complex_t b);
 complex_t complex_sub(complex_t a, complex_t b);
 complex_t complex_mul(complex_t a, complex_t b);
 complex_t complex_exp(double theta);
-double complex_abs(complex_t a);
+nst_real_t complex_abs(complex_t a);
+
+typedef enum
+{
+    SPECTROGRAM_MODE_FFT,         // one FFT every hop_size samples
+    SPECTROGRAM_MODE_SLIDING_DFT, // O(N) update of every bin on every sample
+    SPECTROGRAM_MODE_GOERTZEL,    // Goertzel filters for a few target frequencies
+} spectrogram_mode_t;
+
+// Power averaging across hops; every mode except NONE emits a column every
+// average_count hops
+typedef enum
+{
+    SPECTROGRAM_AVERAGE_NONE,     // a column per hop
+    SPECTROGRAM_AVERAGE_WELCH,    // mean power of the last average_count hops
+    SPECTROGRAM_AVERAGE_EMA,      // exponential moving average of power
+    SPECTROGRAM_AVERAGE_MAX_HOLD, // peak power of the last average_count hops
+} spectrogram_average_t;
 
-void fft(complex_t *X, int N);
+typedef struct
+{
+    spectrogram_mode_t mode;
+    int window_size;
+    int hop_size;   // new samples between columns; 0 derives it from overlap
+    double overlap; // fraction of the window shared by consecutive columns
+    int channel;    // index into nst_event_t.values of the first axis
+    int channel_count;    // consecutive axes transformed together, up to SPECTROGRAM_MAX_CHANNELS
+    int magnitude_vector; // also produce the spectrum of the axis vector magnitude
+    int resync_interval; // sliding DFT: samples between exact FFT resyncs
+    double sample_rate;  // Hz; only used to place Goertzel frequencies
+    const double *goertzel_frequencies; // Goertzel: target frequencies, copied at init
+    int goertzel_count;
+    window_type_t window; // analysis window applied to every frame
+    double kaiser_beta;   // shape of WINDOW_KAISER
+    spectrogram_average_t average;
+    int average_count; // hops per averaged column
+    double ema_alpha;  // EMA weight of the newest hop; 0 uses 2 / (average_count + 1)
+    int power_columns; // columns hold |X|^2 instead of |X|, skipping a sqrt per bin
+} spectrogram_config_t;
 
+// Axes are kept structure-of-arrays: one ring, frame and FFT buffer per axis
 typedef struct
 {
-    nst_event_t *buffer;
-    int buffer_index;
-    double *window;
-    double *spectrogram;
+    int channel;
+    int channel_count;
+    ring_buffer_t rings[SPECTROGRAM_MAX_CHANNELS]; // recent samples of values[channel + c]
+    const nst_real_t *window; // shared table from window_acquire(), NULL for rectangular
+    nst_real_t *spectrogram;  // column of the first axis, same as channel_spectrograms[0]
+    nst_real_t *channel_spectrograms[SPECTROGRAM_MAX_CHANNELS];
+    nst_real_t *magnitude_spectrogram; // power summed over axes in column units, or NULL
     int window_size;
+    int hop_size;
+    int samples_until_column;
+    rfft_plan_t *plan;
+    nst_real_t *frames[SPECTROGRAM_MAX_CHANNELS];         // real input samples for the current window
+    complex_t *fft_buffers[SPECTROGRAM_MAX_CHANNELS]; // window_size / 2 + 1 bins
+
+    spectrogram_mode_t mode;
+    int power_columns;
+    // Sliding DFT bins (window_size / 2 per axis) and per-bin rotations
+    // exp(2*pi*i*k/N), split into real and imaginary arrays so the update
+    // loop vectorizes
+    nst_real_t *sdft_real;
+    nst_real_t *sdft_imag;
+    nst_real_t *sdft_cos;
+    nst_real_t *sdft_sin;
+    // Cosine-sum windows are applied to the sliding DFT in the frequency
+    // domain: X_w[k] = sum_j sdft_kernel[j] * (X[k - j] + X[k + j]), with
+    // the j = 0 tap halved. sdft_padded holds one axis extended by symmetry.
+    int sdft_taps;
+    nst_real_t sdft_kernel[WINDOW_MAX_COSINE_TERMS];
+    complex_t *sdft_padded;
+    int resync_interval;
+    int samples_until_resync;
+
+    // Goertzel bank: 2*cos(w) and the output bin per target, plus filter state
+    int goertzel_count;
+    nst_real_t *goertzel_coeff;
+    int *goertzel_bins;
+    nst_real_t *goertzel_s1;
+    nst_real_t *goertzel_s2;
+
+    // Averaging: the power of every hop is folded into average_power, and
+    // channel_spectrograms holds the averaged column
+    spectrogram_average_t average;
+    int average_count;
+    int hops_until_average;
+    nst_real_t ema_alpha;
+    int ema_primed;
+    nst_real_t psd_scale; // |X[k]|^2 to one-sided PSD per Hz, for k > 0
+    nst_real_t *average_power[SPECTROGRAM_MAX_CHANNELS];
+    nst_real_t *power_spectrograms[SPECTROGRAM_MAX_CHANNELS]; // PSD of the latest column, or NULL
 } spectrogram_state_t;
 
+// Defaults: FFT mode with 50% overlap (hop of window_size / 2) on values[0]
+// only, rectangular window. The sliding DFT mode ignores hop_size and
+// produces a column per sample; it supports the cosine-sum windows and uses
+// a rectangular window in place of Kaiser.
+// The Goertzel mode writes only the bins nearest its target frequencies and
+// leaves the others at zero. With averaging, columns come every
+// average_count hops and power_spectrograms holds the averaged PSD in
+// units^2 / Hz at config->sample_rate.
+void spectrogram_config_default(spectrogram_config_t *config, int window_size);
+
 void init_spectrogram_state(spectrogram_state_t *state, int window_size);
-void algorithm_update(spectrogram_state_t *state, const nst_event_t *input_event);
+// Returns 0 if window_size < 2, channel is outside the event values,
+// Goertzel mode has no frequencies, sample_rate <= 0 or a frequency outside
+// [0, sample_rate / 2], or on allocation failure, leaving the state zeroed
+int init_spectrogram_state_with_config(spectrogram_state_t *state, const spectrogram_config_t *config);
+void free_spectrogram_state(spectrogram_state_t *state);
+
+// Push one sample of every axis; returns 1 when new columns are ready in
+// state->channel_spectrograms (and state->magnitude_spectrogram)
+int algorithm_update(spectrogram_state_t *state, const nst_event_t *input_event);
+
+// Same as algorithm_update() with the axes given directly, frame[c] for
+// axis c of channel_count
+int algorithm_update_frame(spectrogram_state_t *state, const nst_real_t *frame);
+
+// Integer-only spectrogram for targets with a weak or no FPU: FFT mode on a
+// single axis, power-of-two window sizes only. Samples are stored as Q31
+// (int16 input is shifted up by 16 bits), weighted by a Q15 copy of the
+// window, and each column shares one block exponent:
+// |X[k]| = spectrogram[k] * 2^exponent in Q31 units.
+typedef struct
+{
+    int window_size;
+    int hop_size;
+    int samples_until_column;
+    int32_t *samples; // ring of the latest Q31 samples, power-of-two capacity
+    int sample_mask;
+    unsigned long long sample_count;
+    rfft_fixed_plan_t *plan;
+    int16_t *window; // Q15 window weights, NULL for rectangular
+    int32_t *frame;
+    complex_q31_t *fft_buffer; // window_size / 2 + 1 bins
+    uint32_t *spectrogram;     // window_size / 2 magnitudes
+    int exponent;
+    int power_columns;
+} spectrogram_fixed_state_t;
+
+// Uses window_size, hop_size, overlap, window, kaiser_beta and power_columns
+// from config. Returns 0 if the window size is not a power of two >= 4, for
+// any mode but FFT, more than one axis, magnitude_vector or averaging, or on
+// allocation failure.
+int init_spectrogram_fixed_state(spectrogram_fixed_state_t *state, const spectrogram_config_t *config);
+void free_spectrogram_fixed_state(spectrogram_fixed_state_t *state);
+
+// Push one sample; returns 1 when a new column is ready
+int algorithm_update_q15(spectrogram_fixed_state_t *state, int16_t sample);
+int algorithm_update_q31(spectrogram_fixed_state_t *state, int32_t sample);
+
+// Convert the latest column to the format of spectrogram_state_t.spectrogram,
+// |X| or |X|^2 per power_columns. Magnitudes are alpha-max-plus-beta-min
+// estimates, within 4% of the floating-point path. full_scale is the value of a full-scale sample, 32768 LSBs for int16 input
+// and 2^31 for int32.
+void spectrogram_fixed_column(const spectrogram_fixed_state_t *state, nst_real_t full_scale, nst_real_t *out);
 
 #endif // NST_MAIN_H
\ No newline at end of file
@@ -3,6 +3,17 @@
 #include <float.h>
 #include <math.h>
 
+// Precision of the DSP path: sample rings, FFT, windows and magnitudes.
+// Build with NST_SINGLE_PRECISION for float32, which doubles the SIMD width
+// and halves the memory traffic; sensor events stay double either way.
+#ifdef NST_SINGLE_PRECISION
+typedef float nst_real_t;
+#define NST_SQRT sqrtf
+#else
+typedef double nst_real_t;
+#define NST_SQRT sqrt
+#endif
+
 #define SPECTROGRAM_ROWS 256
 #define SPECTROGRAM_COLS 256
 #define NST_EVENT_MAX_VALUES_COUNT 32
@@ -0,0 +1,293 @@
+#include "png_encoder.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <png.h>
+#include <zlib.h>
+
+// Arena blocks are handed out on this boundary
+#define ARENA_ALIGNMENT 16
+
+struct png_encoder
+{
+    png_encoder_options_t options;
+    png_color palette[256];
+
+    // Bump allocator for libpng and zlib, reset for each frame. Requests
+    // that do not fit go to malloc, and the next reset grows the arena to
+    // the whole of the last frame's demand.
+    unsigned char *arena;
+    size_t arena_size;
+    size_t arena_used;
+    size_t overflow_bytes;
+
+    unsigned char *output;
+    size_t output_size;
+    size_t output_capacity;
+
+    unsigned char *row;
+    size_t row_capacity;
+};
+
+void png_encoder_options_default(png_encoder_options_t *options)
+{
+    options->format = PNG_ENCODER_RGBA;
+    options->compression_level = 1;
+    options->compression_strategy = Z_DEFAULT_STRATEGY;
+    options->mem_level = 8;
+    options->filters = PNG_FILTER_NONE;
+}
+
+static const struct
+{
+    const char *name;
+    png_encoder_format_t format;
+} format_names[] = {
+    {"rgba", PNG_ENCODER_RGBA},
+    {"gray", PNG_ENCODER_GRAY},
+    {"palette", PNG_ENCODER_PALETTE},
+};
+
+static const struct
+{
+    const char *name;
+    int value;
+} strategy_names[] = {
+    {"default", Z_DEFAULT_STRATEGY}, {"filtered", Z_FILTERED}, {"huffman", Z_HUFFMAN_ONLY},
+    {"rle", Z_RLE},                  {"fixed", Z_FIXED},
+};
+
+static const struct
+{
+    const char *name;
+    int value;
+} filter_names[] = {
+    {"none", PNG_FILTER_NONE},   {"sub", PNG_FILTER_SUB},       {"up", PNG_FILTER_UP},
+    {"average", PNG_FILTER_AVG}, {"paeth", PNG_FILTER_PAETH},   {"fast", PNG_FAST_FILTERS},
+    {"all", PNG_ALL_FILTERS},
+};
+
+int png_encoder_format_from_name(const char *name, png_encoder_format_t *format)
+{
+    for (size_t i = 0; i < sizeof(format_names) / sizeof(format_names[0]); i++)
+    {
+        if (strcmp(name, format_names[i].name) == 0)
+        {
+            *format = format_names[i].format;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int png_encoder_strategy_from_name(const char *name, int *strategy)
+{
+    for (size_t i = 0; i < sizeof(strategy_names) / sizeof(strategy_names[0]); i++)
+    {
+        if (strcmp(name, strategy_names[i].name) == 0)
+        {
+            *strategy = strategy_names[i].value;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int png_encoder_filters_from_name(const char *name, int *filters)
+{
+    for (size_t i = 0; i < sizeof(filter_names) / sizeof(filter_names[0]); i++)
+    {
+        if (strcmp(name, filter_names[i].name) == 0)
+        {
+            *filters = filter_names[i].value;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+png_encoder_t *png_encoder_create(const png_encoder_options_t *options)
+{
+    png_encoder_t *encoder = (png_encoder_t *)calloc(1, sizeof(png_encoder_t));
+    if (!encoder)
+        return NULL;
+    if (options)
+    {
+        encoder->options = *options;
+    }
+    else
+    {
+        png_encoder_options_default(&encoder->options);
+    }
+    for (int i = 0; i < 256; i++)
+    {
+        encoder->palette[i].red = encoder->palette[i].green = encoder->palette[i].blue = (png_byte)i;
+    }
+    return encoder;
+}
+
+void png_encoder_set_palette(png_encoder_t *encoder, const uint32_t *rgba)
+{
+    for (int i = 0; i < 256; i++)
+    {
+        unsigned char bytes[4];
+        memcpy(bytes, &rgba[i], sizeof(bytes));
+        encoder->palette[i].red = bytes[0];
+        encoder->palette[i].green = bytes[1];
+        encoder->palette[i].blue = bytes[2];
+    }
+}
+
+void png_encoder_destroy(png_encoder_t *encoder)
+{
+    if (!encoder)
+        return;
+    free(encoder->arena);
+    free(encoder->output);
+    free(encoder->row);
+    free(encoder);
+}
+
+static png_voidp arena_malloc(png_structp png_ptr, png_alloc_size_t size)
+{
+    png_encoder_t *encoder = (png_encoder_t *)png_get_mem_ptr(png_ptr);
+    size_t rounded = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    if (encoder->arena_used + rounded <= encoder->arena_size)
+    {
+        void *block = encoder->arena + encoder->arena_used;
+        encoder->arena_used += rounded;
+        return block;
+    }
+    encoder->overflow_bytes += rounded;
+    return malloc(size);
+}
+
+static void arena_free(png_structp png_ptr, png_voidp ptr)
+{
+    png_encoder_t *encoder = (png_encoder_t *)png_get_mem_ptr(png_ptr);
+    unsigned char *block = (unsigned char *)ptr;
+    // Arena blocks go back at the next reset
+    if (block >= encoder->arena && block < encoder->arena + encoder->arena_size)
+        return;
+    free(ptr);
+}
+
+static void arena_reset(png_encoder_t *encoder)
+{
+    if (encoder->overflow_bytes > 0)
+    {
+        size_t size = encoder->arena_used + encoder->overflow_bytes;
+        unsigned char *arena = (unsigned char *)malloc(size);
+        if (arena)
+        {
+            free(encoder->arena);
+            encoder->arena = arena;
+            encoder->arena_size = size;
+        }
+    }
+    encoder->arena_used = 0;
+    encoder->overflow_bytes = 0;
+}
+
+static void write_output(png_structp png_ptr, png_bytep data, size_t length)
+{
+    png_encoder_t *encoder = (png_encoder_t *)png_get_io_ptr(png_ptr);
+    if (encoder->output_size + length > encoder->output_capacity)
+    {
+        size_t capacity = encoder->output_capacity ? encoder->output_capacity : 4096;
+        while (capacity < encoder->output_size + length)
+        {
+            capacity *= 2;
+        }
+        unsigned char *output = (unsigned char *)realloc(encoder->output, capacity);
+        if (!output)
+        {
+            png_error(png_ptr, "out of memory for PNG output");
+        }
+        encoder->output = output;
+        encoder->output_capacity = capacity;
+    }
+    memcpy(encoder->output + encoder->output_size, data, length);
+    encoder->output_size += length;
+}
+
+static void flush_output(png_structp png_ptr)
+{
+    (void)png_ptr;
+}
+
+const unsigned char *png_encoder_encode_ring(png_encoder_t *encoder, const image_ring_t *image, size_t *png_size)
+{
+    png_encoder_format_t format = encoder->options.format;
+    if (image->bytes_per_pixel != (format == PNG_ENCODER_RGBA ? 4u : 1u))
+        return NULL;
+
+    size_t row_bytes = (size_t)image->width * image->bytes_per_pixel;
+    if (row_bytes > encoder->row_capacity)
+    {
+        unsigned char *row = (unsigned char *)realloc(encoder->row, row_bytes);
+        if (!row)
+            return NULL;
+        encoder->row = row;
+        encoder->row_capacity = row_bytes;
+    }
+
+    arena_reset(encoder);
+    encoder->output_size = 0;
+
+    png_structp png_ptr =
+        png_create_write_struct_2(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL, encoder, arena_malloc, arena_free);
+    if (!png_ptr)
+        return NULL;
+
+    png_infop info_ptr = png_create_info_struct(png_ptr);
+    if (!info_ptr)
+    {
+        png_destroy_write_struct(&png_ptr, NULL);
+        return NULL;
+    }
+
+    if (setjmp(png_jmpbuf(png_ptr)))
+    {
+        png_destroy_write_struct(&png_ptr, &info_ptr);
+        return NULL;
+    }
+
+    png_set_write_fn(png_ptr, encoder, write_output, flush_output);
+    png_set_compression_level(png_ptr, encoder->options.compression_level);
+    png_set_compression_strategy(png_ptr, encoder->options.compression_strategy);
+    png_set_compression_mem_level(png_ptr, encoder->options.mem_level);
+    png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, encoder->options.filters);
+
+    int color_type = format == PNG_ENCODER_RGBA   ? PNG_COLOR_TYPE_RGBA
+                     : format == PNG_ENCODER_GRAY ? PNG_COLOR_TYPE_GRAY
+                                                  : PNG_COLOR_TYPE_PALETTE;
+    png_set_IHDR(png_ptr, info_ptr, image->width, image->height, 8, color_type, PNG_INTERLACE_NONE,
+                 PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    if (format == PNG_ENCODER_PALETTE)
+    {
+        png_set_PLTE(png_ptr, info_ptr, encoder->palette, 256);
+    }
+    png_write_info(png_ptr, info_ptr);
+
+    // Unwrapped rows go straight from the ring; wrapped ones are joined
+    for (unsigned y = 0; y < image->height; ++y)
+    {
+        image_ring_span_t spans[2];
+        if (image_ring_row(image, y, spans) == 1)
+        {
+            png_write_row(png_ptr, (png_const_bytep)spans[0].data);
+        }
+        else
+        {
+            image_ring_copy_row(image, y, encoder->row);
+            png_write_row(png_ptr, encoder->row);
+        }
+    }
+
+    png_write_end(png_ptr, NULL);
+    png_destroy_write_struct(&png_ptr, &info_ptr);
+
+    *png_size = encoder->output_size;
+    return encoder->output;
+}
@@ -0,0 +1,64 @@
+#ifndef PNG_ENCODER_H
+#define PNG_ENCODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../image_ring/image_ring.h"
+
+// Pixel format of the image and the PNG. RGBA images have 4 bytes per
+// pixel; gray and palette images have one 8-bit level per pixel, written as
+// is or as an index into the palette from png_encoder_set_palette().
+typedef enum
+{
+    PNG_ENCODER_RGBA,
+    PNG_ENCODER_GRAY,
+    PNG_ENCODER_PALETTE,
+} png_encoder_format_t;
+
+// "rgba", "gray" or "palette". Returns 0 for an unknown name.
+int png_encoder_format_from_name(const char *name, png_encoder_format_t *format);
+
+// zlib and libpng settings for each frame
+typedef struct
+{
+    png_encoder_format_t format;
+    int compression_level;    // zlib level, 0 to 9
+    int compression_strategy; // zlib strategy, e.g. Z_RLE
+    int mem_level;            // zlib memLevel, 1 to 9; lower shrinks the hash tables
+    int filters;              // mask of PNG_FILTER_* row filters to choose from
+} png_encoder_options_t;
+
+// Defaults for small colormapped frames: RGBA, level 1, the default
+// strategy and memLevel, and no row filter. Filtering RGBA colormap output
+// breaks up the repeated 4-byte colours that deflate matches; on 32x32
+// frames this is both the fastest setting and smaller than libpng's defaults.
+void png_encoder_options_default(png_encoder_options_t *options);
+
+// "default", "filtered", "huffman", "rle" or "fixed". Returns 0 for an
+// unknown name.
+int png_encoder_strategy_from_name(const char *name, int *strategy);
+
+// "none", "sub", "up", "average", "paeth", "fast" (none, sub and up) or
+// "all". Returns 0 for an unknown name.
+int png_encoder_filters_from_name(const char *name, int *filters);
+
+// Encoder kept across frames. libpng needs a fresh png_struct per image,
+// but everything it and zlib allocate comes from an arena that is reset
+// for each frame, and the output accumulates in a buffer that is reused,
+// so steady-state frames make no heap allocations.
+typedef struct png_encoder png_encoder_t;
+
+// Returns NULL on allocation failure
+png_encoder_t *png_encoder_create(const png_encoder_options_t *options);
+void png_encoder_destroy(png_encoder_t *encoder);
+
+// Palette for PNG_ENCODER_PALETTE, 256 RGBA entries as in colormap_t.
+// Alpha is dropped; until this is called the palette is gray.
+void png_encoder_set_palette(png_encoder_t *encoder, const uint32_t *rgba);
+
+// Encode a ring, oldest column first, with 4 bytes per pixel for RGBA and 1
+// otherwise. Returns the PNG, which stays valid until the next call, and
+// its size in *png_size; NULL on failure.
+const unsigned char *png_encoder_encode_ring(png_encoder_t *encoder, const image_ring_t *image, size_t *png_size);
+
+#endif // PNG_ENCODER_H
@@ -0,0 +1,262 @@
+#include "remap.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const struct
+{
+    const char *name;
+    remap_scale_t scale;
+} scale_names[] = {
+    {"linear", REMAP_LINEAR},
+    {"log", REMAP_LOG},
+    {"mel", REMAP_MEL},
+    {"constant_q", REMAP_CONSTANT_Q},
+};
+
+int remap_scale_from_name(const char *name, remap_scale_t *scale)
+{
+    for (size_t i = 0; i < sizeof(scale_names) / sizeof(scale_names[0]); i++)
+    {
+        if (strcmp(name, scale_names[i].name) == 0)
+        {
+            *scale = scale_names[i].scale;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Rows are evenly spaced in u = to_scale(f)
+static double to_scale(remap_scale_t scale, double f)
+{
+    switch (scale)
+    {
+    case REMAP_LOG:
+    case REMAP_CONSTANT_Q:
+        return log(f);
+    case REMAP_MEL:
+        return 2595.0 * log10(1.0 + f / 700.0);
+    default:
+        return f;
+    }
+}
+
+static double from_scale(remap_scale_t scale, double u)
+{
+    switch (scale)
+    {
+    case REMAP_LOG:
+    case REMAP_CONSTANT_Q:
+        return exp(u);
+    case REMAP_MEL:
+        return 700.0 * (pow(10.0, u / 2595.0) - 1.0);
+    default:
+        return u;
+    }
+}
+
+// Weight of a bin at frequency f for a row centred on center with band
+// [low, high]: a triangle reaching the neighbouring rows, or for constant-Q
+// a Hann bump whose half-height width is the row spacing
+static double band_weight(remap_scale_t scale, double f, double low, double center, double high)
+{
+    if (f <= low || f >= high)
+        return 0.0;
+    if (scale == REMAP_CONSTANT_Q)
+        return 0.5 * (1.0 + cos(M_PI * (f - center) / (high - center)));
+    return f <= center ? (f - low) / (center - low) : (high - f) / (high - center);
+}
+
+// Append the weights of one row, padded with zero weights to a multiple of
+// 4 where the column allows, and return their count
+static int add_band(remap_t *remap, int row, int start, int length, const double *band, int offset)
+{
+    int padded = (length + 3) & ~3;
+    if (padded > remap->bins)
+    {
+        padded = length;
+    }
+    int lead = 0;
+    if (start + padded > remap->bins)
+    {
+        lead = start + padded - remap->bins;
+        start -= lead;
+    }
+
+    remap->band_start[row] = start;
+    remap->band_length[row] = padded;
+    remap->weight_offset[row] = offset;
+    for (int j = 0; j < padded; j++)
+    {
+        int i = j - lead;
+        remap->weights[offset + j] = (nst_real_t)(i >= 0 && i < length ? band[i] : 0.0);
+    }
+    return padded;
+}
+
+remap_t *remap_create(remap_scale_t scale, int bins, int rows, double bin_width,
+                      double min_frequency, double max_frequency)
+{
+    if (bins < 2 || rows < 1 || bin_width <= 0)
+        return NULL;
+
+    double top = (bins - 1) * bin_width;
+    int log_scale = scale == REMAP_LOG || scale == REMAP_CONSTANT_Q;
+    if (min_frequency <= 0)
+    {
+        min_frequency = log_scale ? bin_width : 0.0;
+    }
+    if (max_frequency <= 0 || max_frequency > top)
+    {
+        max_frequency = top;
+    }
+    if (min_frequency >= max_frequency)
+        return NULL;
+
+    remap_t *remap = (remap_t *)calloc(1, sizeof(remap_t));
+    if (!remap)
+        return NULL;
+    remap->bins = bins;
+    remap->rows = rows;
+    remap->band_start = (int *)malloc(rows * sizeof(int));
+    remap->band_length = (int *)malloc(rows * sizeof(int));
+    remap->weight_offset = (int *)malloc(rows * sizeof(int));
+    remap->row_frequency = (double *)malloc(rows * sizeof(double));
+    double *band = (double *)malloc(bins * sizeof(double));
+    if (!remap->band_start || !remap->band_length || !remap->weight_offset || !remap->row_frequency || !band)
+    {
+        free(band);
+        remap_destroy(remap);
+        return NULL;
+    }
+
+    double u_min = to_scale(scale, min_frequency);
+    double u_max = to_scale(scale, max_frequency);
+    double step = rows > 1 ? (u_max - u_min) / (rows - 1) : u_max - u_min;
+
+    // Two passes: size the weight array, then fill it
+    int total = 0;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        int offset = 0;
+        for (int r = 0; r < rows; r++)
+        {
+            double u = rows > 1 ? u_min + r * step : 0.5 * (u_min + u_max);
+            double center = from_scale(scale, u);
+            remap->row_frequency[r] = center;
+            double low = from_scale(scale, u - step);
+            double high = from_scale(scale, u + step);
+            if (scale == REMAP_CONSTANT_Q)
+            {
+                // Symmetric in linear frequency, width proportional to center
+                double half = 0.5 * (high - low);
+                low = center - half;
+                high = center + half;
+            }
+
+            int start = 0;
+            int length = 0;
+            double sum = 0.0;
+            if (high - low >= 2 * bin_width)
+            {
+                start = (int)ceil(low / bin_width);
+                int end = (int)floor(high / bin_width);
+                start = start < 0 ? 0 : start;
+                end = end > bins - 1 ? bins - 1 : end;
+                length = end - start + 1;
+                for (int i = 0; i < length; i++)
+                {
+                    band[i] = band_weight(scale, (start + i) * bin_width, low, center, high);
+                    sum += band[i];
+                }
+            }
+
+            if (sum > 0.0)
+            {
+                for (int i = 0; i < length; i++)
+                {
+                    band[i] /= sum;
+                }
+            }
+            else
+            {
+                // Narrower than a bin: interpolate between its neighbours
+                double position = center / bin_width;
+                start = (int)floor(position);
+                start = start > bins - 2 ? bins - 2 : (start < 0 ? 0 : start);
+                double frac = position - start;
+                frac = frac < 0 ? 0 : (frac > 1 ? 1 : frac);
+                band[0] = 1.0 - frac;
+                band[1] = frac;
+                length = 2;
+            }
+
+            if (pass == 0)
+            {
+                offset += (length + 3) & ~3;
+            }
+            else
+            {
+                offset += add_band(remap, r, start, length, band, offset);
+            }
+        }
+
+        if (pass == 0)
+        {
+            total = offset;
+            remap->weights = (nst_real_t *)malloc(total * sizeof(nst_real_t));
+            if (!remap->weights)
+            {
+                free(band);
+                remap_destroy(remap);
+                return NULL;
+            }
+        }
+    }
+
+    free(band);
+    return remap;
+}
+
+void remap_destroy(remap_t *remap)
+{
+    if (!remap)
+        return;
+    free(remap->band_start);
+    free(remap->band_length);
+    free(remap->weight_offset);
+    free(remap->row_frequency);
+    free(remap->weights);
+    free(remap);
+}
+
+void remap_apply(const remap_t *remap, const nst_real_t *in, nst_real_t *out)
+{
+    for (int r = 0; r < remap->rows; r++)
+    {
+        const nst_real_t *x = in + remap->band_start[r];
+        const nst_real_t *w = remap->weights + remap->weight_offset[r];
+        int length = remap->band_length[r];
+
+        // Four independent sums let the compiler keep them in one vector
+        nst_real_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        int j = 0;
+        for (; j + 4 <= length; j += 4)
+        {
+            s0 += w[j] * x[j];
+            s1 += w[j + 1] * x[j + 1];
+            s2 += w[j + 2] * x[j + 2];
+            s3 += w[j + 3] * x[j + 3];
+        }
+        for (; j < length; j++)
+        {
+            s0 += w[j] * x[j];
+        }
+        out[r] = (s0 + s2) + (s1 + s3);
+    }
+}
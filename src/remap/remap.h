@@ -0,0 +1,45 @@
+#ifndef REMAP_H
+#define REMAP_H
+
+#include "../nst_types.h"
+
+// Resamples a column of linear FFT bins onto image rows spaced on another
+// frequency scale. Every row is a weighted average of one contiguous band
+// of bins, so the weights form a banded sparse matrix that is built once
+// and applied as a short dense dot product per row.
+typedef enum
+{
+    REMAP_LINEAR,
+    REMAP_LOG,
+    REMAP_MEL,
+    REMAP_CONSTANT_Q,
+} remap_scale_t;
+
+typedef struct
+{
+    int bins;
+    int rows;
+    int *band_start;     // first bin of each row
+    int *band_length;    // bins in each row, padded to a multiple of 4
+    int *weight_offset;  // index of each row's first weight
+    double *row_frequency; // centre of each row in Hz
+    nst_real_t *weights; // all bands back to back
+} remap_t;
+
+// Parse "linear", "log", "mel" or "constant_q". Returns 0 for an unknown name.
+int remap_scale_from_name(const char *name, remap_scale_t *scale);
+
+// Rows from min_frequency (row 0) up to max_frequency (row rows - 1) for
+// bins bins of bin_width Hz each; bin k is centred on k * bin_width.
+// min_frequency <= 0 starts at the first non-DC bin for the log scales and
+// at DC otherwise; max_frequency <= 0 ends at the last bin. Low rows that
+// are narrower than a bin interpolate between the two nearest bins.
+// Returns NULL on bad sizes or allocation failure.
+remap_t *remap_create(remap_scale_t scale, int bins, int rows, double bin_width,
+                      double min_frequency, double max_frequency);
+void remap_destroy(remap_t *remap);
+
+// out[r] = sum over the band of row r of weight * in[bin]
+void remap_apply(const remap_t *remap, const nst_real_t *in, nst_real_t *out);
+
+#endif // REMAP_H
@@ -0,0 +1,77 @@
+#include "ring_buffer.h"
+#include <stdlib.h>
+#include <string.h>
+
+int ring_buffer_init(ring_buffer_t *ring, int min_capacity)
+{
+    int capacity = 1;
+    while (capacity < min_capacity)
+    {
+        capacity <<= 1;
+    }
+
+    ring->data = (nst_real_t *)calloc(capacity, sizeof(nst_real_t));
+    ring->capacity = capacity;
+    ring->mask = capacity - 1;
+    ring->count = 0;
+    return ring->data != NULL;
+}
+
+void ring_buffer_free(ring_buffer_t *ring)
+{
+    free(ring->data);
+    ring->data = NULL;
+    ring->capacity = 0;
+    ring->mask = 0;
+    ring->count = 0;
+}
+
+ring_buffer_view_t ring_buffer_window(const ring_buffer_t *ring, int length)
+{
+    ring_buffer_view_t view;
+    int start = (int)((ring->count - (unsigned long long)length) & ring->mask);
+    int tail = ring->capacity - start;
+
+    view.first = ring->data + start;
+    if (length <= tail)
+    {
+        view.first_length = length;
+        view.second = ring->data;
+        view.second_length = 0;
+    }
+    else
+    {
+        view.first_length = tail;
+        view.second = ring->data;
+        view.second_length = length - tail;
+    }
+    return view;
+}
+
+void ring_buffer_copy_window(const ring_buffer_t *ring, int length, nst_real_t *out)
+{
+    ring_buffer_view_t view = ring_buffer_window(ring, length);
+    memcpy(out, view.first, view.first_length * sizeof(nst_real_t));
+    memcpy(out + view.first_length, view.second, view.second_length * sizeof(nst_real_t));
+}
+
+void ring_buffer_copy_window_weighted(const ring_buffer_t *ring, int length, const nst_real_t *weights, nst_real_t *out)
+{
+    if (!weights)
+    {
+        ring_buffer_copy_window(ring, length, out);
+        return;
+    }
+
+    ring_buffer_view_t view = ring_buffer_window(ring, length);
+    for (int i = 0; i < view.first_length; i++)
+    {
+        out[i] = view.first[i] * weights[i];
+    }
+    out += view.first_length;
+    weights += view.first_length;
+    for (int i = 0; i < view.second_length; i++)
+    {
+        out[i] = view.second[i] * weights[i];
+    }
+}
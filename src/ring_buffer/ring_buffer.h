@@ -0,0 +1,55 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include "../nst_types.h"
+
+// Power-of-two ring of samples for a single axis. Writing never moves data;
+// windows are read back as at most two contiguous segments.
+typedef struct
+{
+    nst_real_t *data;
+    int capacity;             // power of two
+    int mask;                 // capacity - 1
+    unsigned long long count; // total samples written
+} ring_buffer_t;
+
+// The newest samples of a ring in time order: first[0..first_length)
+// followed by second[0..second_length). Valid until the next push.
+typedef struct
+{
+    const nst_real_t *first;
+    int first_length;
+    const nst_real_t *second;
+    int second_length;
+} ring_buffer_view_t;
+
+// Allocate a zero-filled ring holding at least min_capacity samples.
+// Returns 0 on allocation failure.
+int ring_buffer_init(ring_buffer_t *ring, int min_capacity);
+void ring_buffer_free(ring_buffer_t *ring);
+
+static inline void ring_buffer_push(ring_buffer_t *ring, nst_real_t sample)
+{
+    ring->data[ring->count & ring->mask] = sample;
+    ring->count++;
+}
+
+// Sample pushed age pushes before the newest one (age 0 is the newest,
+// age < capacity).
+static inline nst_real_t ring_buffer_sample(const ring_buffer_t *ring, int age)
+{
+    return ring->data[(ring->count - 1 - (unsigned long long)age) & ring->mask];
+}
+
+// View of the latest length samples (length <= capacity). Samples before the
+// first push read as zero.
+ring_buffer_view_t ring_buffer_window(const ring_buffer_t *ring, int length);
+
+// Copy the latest length samples into out in time order.
+void ring_buffer_copy_window(const ring_buffer_t *ring, int length, nst_real_t *out);
+
+// Copy the latest length samples multiplied by weights[0..length), so a
+// window function costs no pass of its own. NULL weights copy unweighted.
+void ring_buffer_copy_window_weighted(const ring_buffer_t *ring, int length, const nst_real_t *weights, nst_real_t *out);
+
+#endif // RING_BUFFER_H
@@ -5,10 +5,12 @@
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <chrono>
 #include <cstring>
@@ -20,43 +22,27 @@ extern "C"
 {
 #include "nst_main.h"
 #include "image_utils/image_utils.h"
+#include "log/log.h"
+#include "remap/remap.h"
+#include "decibel/decibel.h"
+#include "autogain/autogain.h"
+#include "colormap/colormap.h"
+#include "png_encoder/png_encoder.h"
+#include "tensor_message/tensor_message.h"
+#include "base64/base64.h"
 }
 
 // Define the array dimensions
 const int ROWS = 32;
 const int COLS = 32;
-const int CHANNELS = 4;
 
-void updateSlidingWindow(unsigned char ***image, unsigned char **newCol, int *currentIndex)
+// What each new column is written as
+enum output_mode_t
 {
-    printf("Updating sliding window current index: %d\n", *currentIndex);
-    // Update each row in the circular buffer
-    for (int i = 0; i < ROWS; ++i)
-    {
-        memcpy(image[*currentIndex][i], newCol[i], CHANNELS * sizeof(unsigned char));
-    }
-
-    // Move to the next index in the circular buffer
-    *currentIndex = (*currentIndex + 1) % COLS;
-}
-
-void spectrogramToRGB(const double *spectrogram, unsigned char **newCol)
-{
-    for (int i = 0; i < ROWS; ++i)
-    {
-        // Normalize the spectrogram value
-        double normalizedValue = spectrogram[i] / 0.01;
-
-        // Convert the normalized value to RGB (simple grayscale for this example)
-        unsigned char rgbValue = static_cast<unsigned char>((int)normalizedValue % 256);
-
-        // Populate the newCol with the RGB values
-        newCol[i][0] = rgbValue;      // Red
-        newCol[i][1] = rgbValue; // Green
-        newCol[i][2] = rgbValue; // Blue
-        newCol[i][3] = 255;      // Alpha (fully opaque)
-    }
-}
+    OUTPUT_PNG,       // foxglove.CompressedImage of the scrolling image
+    OUTPUT_RAW_IMAGE, // foxglove.RawImage of the same image, uncompressed
+    OUTPUT_TENSOR,    // the column itself, see tensor_message.h
+};
 
 static struct cag_option options[] = {
     {.identifier = 'i',
@@ -87,7 +73,13 @@ static struct cag_option options[] = {
      .access_letters = "e",
      .access_name = "end_time",
      .value_name = "END_TIME",
-     .description = "End time"}};
+     .description = "End time"},
+
+    {.identifier = 'l',
+     .access_letters = "l",
+     .access_name = "log_level",
+     .value_name = "LEVEL",
+     .description = "Log level: off, error, warn, info, debug or trace"}};
 
 int main(int argc, char *argv[])
 {
@@ -97,22 +89,22 @@ int main(int argc, char *argv[])
     bool write_output = false;
 
     spectrogram_state_t state;
-    unsigned char ***image = (unsigned char ***)malloc(COLS * sizeof(unsigned char **));
-    for (int i = 0; i < COLS; ++i)
-    {
-        image[i] = (unsigned char **)malloc(ROWS * sizeof(unsigned char *));
-        for (int j = 0; j < ROWS; ++j)
-        {
-            image[i][j] = (unsigned char *)malloc(CHANNELS * sizeof(unsigned char));
-        }
-    }
-
-    int currentIndex = 0; // Circular buffer index
-    unsigned char **newCol = (unsigned char **)malloc(ROWS * sizeof(char *));
-    for (int i = 0; i < ROWS; ++i)
-    {
-        newCol[i] = (unsigned char *)malloc(CHANNELS * sizeof(char));
-    }
+    image_ring_t *image = NULL; // scrolling spectrogram, RGBA or one level per pixel
+    int render_channel = 0; // axis to draw; -1 draws the magnitude vector
+    remap_t *remap = NULL;  // bins to rows on another frequency scale, or NULL for bin i on row i
+    std::vector<nst_real_t> remapped(ROWS);
+    output_mode_t output_mode = OUTPUT_PNG;
+    tensor_dtype_t tensor_dtype = TENSOR_FLOAT32;
+    int rendered_rows = 0;                 // rows with data; the image pads to ROWS with level 0
+    std::vector<uint8_t> levels;           // 8-bit level per row
+    std::vector<float> tensor_frequencies; // row centres for tensor messages
+    std::vector<float> tensor_values;
+    std::vector<unsigned char> message_buffer; // tensor message or unrolled raw image
+    decibel_quantizer_t quantizer; // column power to 8-bit levels
+    autogain_t *autogain = NULL;   // adaptive replacement for quantizer, or NULL
+    colormap_t colormap;           // levels to RGBA, or the PNG palette
+    std::vector<uint32_t> newCol(ROWS);
+    png_encoder_t *png_encoder = NULL; // kept across frames
 
     cag_option_context context;
     cag_option_init(&context, options, CAG_ARRAY_SIZE(options), argc, argv);
@@ -129,6 +121,16 @@ int main(int argc, char *argv[])
         case 'p':
             param_file = cag_option_get_value(&context);
             break;
+        case 'l':
+        {
+            const char *level = cag_option_get_value(&context);
+            if (!level || !nst_log_level_from_name(level, &nst_log_level))
+            {
+                fprintf(stderr, "Unknown log level %s\n", level ? level : "");
+                return EXIT_FAILURE;
+            }
+            break;
+        }
         case '?':
             cag_option_print_error(&context, stdout);
             return EXIT_FAILURE;
@@ -143,9 +145,8 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    // Your logic using infile, outfile
-    printf("Input file: %s\n", infile);
-    printf("Output file: %s\n", outfile);
+    NST_LOG_INFO("Input file: %s\n", infile);
+    NST_LOG_INFO("Output file: %s\n", outfile);
 
     mcap::McapReader reader;
     {
@@ -159,8 +160,28 @@ int main(int argc, char *argv[])
     }
 
     {
-
-        init_spectrogram_state(&state, COLS);
+        spectrogram_config_t config;
+        spectrogram_config_default(&config, COLS);
+        std::vector<double> goertzel_frequencies;
+        std::string frequency_scale;
+        double min_frequency = 0.0;
+        double max_frequency = 0.0;
+        double db_floor = -40.0;
+        double db_ceiling = 20.0;
+        std::string auto_gain = "off";
+        double gain_low_quantile = 0.05;
+        double gain_high_quantile = 0.995;
+        double gain_min_range_db = 20.0;
+        std::string colormap_name = "gray";
+        png_encoder_options_t png_options;
+        png_encoder_options_default(&png_options);
+        // The colormap goes in the PLTE chunk, a quarter of the RGBA bytes
+        png_options.format = PNG_ENCODER_PALETTE;
+        std::string png_format;
+        std::string png_strategy;
+        std::string png_filter;
+        std::string output = "png";
+        std::string tensor_dtype_name = "float32";
 
         if (param_file)
         {
@@ -177,7 +198,258 @@ int main(int argc, char *argv[])
 
             // Set struct members from JSON
             // here is where we can pass in parameters to the algorithm
+            config.window_size = j.value("window_size", config.window_size);
+            config.hop_size = j.value("hop_size", config.hop_size);
+            config.overlap = j.value("overlap", config.overlap);
+            config.resync_interval = j.value("resync_interval", config.resync_interval);
+            config.channel = j.value("channel", config.channel);
+            config.channel_count = j.value("channel_count", config.channel_count);
+            config.magnitude_vector = j.value("magnitude_vector", config.magnitude_vector != 0);
+            render_channel = j.value("render_channel", render_channel);
+
+            config.sample_rate = j.value("sample_rate", config.sample_rate);
+            if (j.contains("goertzel_frequencies"))
+            {
+                goertzel_frequencies = j["goertzel_frequencies"].get<std::vector<double>>();
+                config.goertzel_frequencies = goertzel_frequencies.data();
+                config.goertzel_count = (int)goertzel_frequencies.size();
+            }
+
+            std::string mode = j.value("mode", std::string("fft"));
+            if (mode == "sliding_dft")
+            {
+                config.mode = SPECTROGRAM_MODE_SLIDING_DFT;
+            }
+            else if (mode == "goertzel")
+            {
+                config.mode = SPECTROGRAM_MODE_GOERTZEL;
+            }
+            else if (mode != "fft")
+            {
+                std::cerr << "Unknown mode " << mode << ", using fft" << std::endl;
+            }
+
+            std::string window = j.value("window", std::string("rectangular"));
+            if (!window_type_from_name(window.c_str(), &config.window))
+            {
+                std::cerr << "Unknown window " << window << ", using rectangular" << std::endl;
+            }
+            config.kaiser_beta = j.value("kaiser_beta", config.kaiser_beta);
+
+            std::string average = j.value("average", std::string("none"));
+            if (average == "welch")
+            {
+                config.average = SPECTROGRAM_AVERAGE_WELCH;
+            }
+            else if (average == "ema")
+            {
+                config.average = SPECTROGRAM_AVERAGE_EMA;
+            }
+            else if (average == "max_hold")
+            {
+                config.average = SPECTROGRAM_AVERAGE_MAX_HOLD;
+            }
+            else if (average != "none")
+            {
+                std::cerr << "Unknown average " << average << ", using none" << std::endl;
+            }
+            config.average_count = j.value("average_count", config.average_count);
+            config.ema_alpha = j.value("ema_alpha", config.ema_alpha);
+
+            frequency_scale = j.value("frequency_scale", frequency_scale);
+            min_frequency = j.value("min_frequency", min_frequency);
+            max_frequency = j.value("max_frequency", max_frequency);
+            db_floor = j.value("db_floor", db_floor);
+            db_ceiling = j.value("db_ceiling", db_ceiling);
+            auto_gain = j.value("auto_gain", auto_gain);
+            gain_low_quantile = j.value("gain_low_quantile", gain_low_quantile);
+            gain_high_quantile = j.value("gain_high_quantile", gain_high_quantile);
+            gain_min_range_db = j.value("gain_min_range_db", gain_min_range_db);
+            colormap_name = j.value("colormap", colormap_name);
+            png_options.compression_level = j.value("png_compression_level", png_options.compression_level);
+            png_options.mem_level = j.value("png_mem_level", png_options.mem_level);
+            png_strategy = j.value("png_strategy", png_strategy);
+            png_filter = j.value("png_filter", png_filter);
+            png_format = j.value("png_format", png_format);
+            output = j.value("output", output);
+            tensor_dtype_name = j.value("tensor_dtype", tensor_dtype_name);
+        }
+
+        if (output == "raw_image")
+        {
+            output_mode = OUTPUT_RAW_IMAGE;
+        }
+        else if (output == "tensor")
+        {
+            output_mode = OUTPUT_TENSOR;
+        }
+        else if (output != "png")
+        {
+            NST_LOG_ERROR("Unknown output %s\n", output.c_str());
+            return EXIT_FAILURE;
+        }
+        if (!tensor_dtype_from_name(tensor_dtype_name.c_str(), &tensor_dtype))
+        {
+            NST_LOG_ERROR("Unknown tensor_dtype %s\n", tensor_dtype_name.c_str());
+            return EXIT_FAILURE;
+        }
+
+        colormap_type_t colormap_type;
+        if (!colormap_type_from_name(colormap_name.c_str(), &colormap_type))
+        {
+            NST_LOG_ERROR("Unknown colormap %s\n", colormap_name.c_str());
+            return EXIT_FAILURE;
+        }
+        colormap_init(&colormap, colormap_type);
+
+        if (!png_strategy.empty() &&
+            !png_encoder_strategy_from_name(png_strategy.c_str(), &png_options.compression_strategy))
+        {
+            NST_LOG_ERROR("Unknown png_strategy %s\n", png_strategy.c_str());
+            return EXIT_FAILURE;
+        }
+        if (!png_filter.empty() && !png_encoder_filters_from_name(png_filter.c_str(), &png_options.filters))
+        {
+            NST_LOG_ERROR("Unknown png_filter %s\n", png_filter.c_str());
+            return EXIT_FAILURE;
+        }
+        if (!png_format.empty() && !png_encoder_format_from_name(png_format.c_str(), &png_options.format))
+        {
+            NST_LOG_ERROR("Unknown png_format %s\n", png_format.c_str());
+            return EXIT_FAILURE;
+        }
+        if (png_options.format == PNG_ENCODER_GRAY && colormap_type != COLORMAP_GRAY)
+        {
+            NST_LOG_WARN("png_format gray ignores colormap %s\n", colormap_name.c_str());
+        }
+        if (output_mode == OUTPUT_PNG)
+        {
+            png_encoder = png_encoder_create(&png_options);
+            if (!png_encoder)
+            {
+                NST_LOG_ERROR("Could not set up the PNG encoder\n");
+                return EXIT_FAILURE;
+            }
+            png_encoder_set_palette(png_encoder, colormap.rgba);
+        }
+
+        if (output_mode != OUTPUT_TENSOR)
+        {
+            // Gray and palette PNGs take the levels as they are, and so does
+            // a raw mono8 image when the colormap is gray
+            bool one_byte = output_mode == OUTPUT_PNG ? png_options.format != PNG_ENCODER_RGBA
+                                                      : colormap_type == COLORMAP_GRAY;
+            image = image_ring_create(COLS, ROWS, one_byte ? 1 : 4);
+            if (!image)
+            {
+                NST_LOG_ERROR("Could not allocate a %dx%d image\n", COLS, ROWS);
+                return EXIT_FAILURE;
+            }
+        }
+
+        // The renderer works in dB of power, which needs no sqrt per bin
+        config.power_columns = 1;
+        if (!decibel_quantizer_init(&quantizer, db_floor, db_ceiling))
+        {
+            NST_LOG_ERROR("db_floor %g must be below db_ceiling %g\n", db_floor, db_ceiling);
+            return EXIT_FAILURE;
+        }
+
+        if (config.mode == SPECTROGRAM_MODE_GOERTZEL)
+        {
+            if (config.goertzel_count < 1)
+            {
+                NST_LOG_ERROR("Goertzel mode needs at least one entry in goertzel_frequencies\n");
+                return EXIT_FAILURE;
+            }
+            if (!(config.sample_rate > 0))
+            {
+                NST_LOG_ERROR("Goertzel mode needs sample_rate > 0, not %g\n", config.sample_rate);
+                return EXIT_FAILURE;
+            }
+            for (double f : goertzel_frequencies)
+            {
+                if (!(f >= 0 && f <= 0.5 * config.sample_rate))
+                {
+                    NST_LOG_ERROR("goertzel_frequencies entry %g Hz is outside 0 to %g Hz, half of sample_rate\n",
+                                  f, 0.5 * config.sample_rate);
+                    return EXIT_FAILURE;
+                }
+            }
         }
+        if (!init_spectrogram_state_with_config(&state, &config))
+        {
+            NST_LOG_ERROR("Could not set up a spectrogram with window size %d on channel %d\n", config.window_size,
+                          config.channel);
+            return EXIT_FAILURE;
+        }
+
+        if (!frequency_scale.empty())
+        {
+            remap_scale_t scale;
+            if (!remap_scale_from_name(frequency_scale.c_str(), &scale))
+            {
+                NST_LOG_ERROR("Unknown frequency scale %s\n", frequency_scale.c_str());
+                return EXIT_FAILURE;
+            }
+            remap = remap_create(scale, state.window_size / 2, ROWS, config.sample_rate / state.window_size,
+                                 min_frequency, max_frequency);
+            if (!remap)
+            {
+                NST_LOG_ERROR("Could not map %d bins onto %d rows between %g and %g Hz\n",
+                              state.window_size / 2, ROWS, min_frequency, max_frequency);
+                return EXIT_FAILURE;
+            }
+        }
+
+        // Tensors carry every bin; the image has room for ROWS
+        rendered_rows = remap ? ROWS : state.window_size / 2;
+        if (output_mode != OUTPUT_TENSOR)
+        {
+            rendered_rows = std::min(rendered_rows, ROWS);
+        }
+        levels.assign(std::max(rendered_rows, ROWS), 0);
+        if (output_mode == OUTPUT_TENSOR)
+        {
+            size_t message_size = tensor_message_size(tensor_dtype, rendered_rows);
+            if (message_size == 0)
+            {
+                NST_LOG_ERROR("Tensor output holds at most %d rows, not %d\n", TENSOR_MESSAGE_MAX_ROWS,
+                              rendered_rows);
+                return EXIT_FAILURE;
+            }
+            message_buffer.resize(message_size);
+            tensor_frequencies.resize(rendered_rows);
+            tensor_values.resize(rendered_rows);
+            for (int r = 0; r < rendered_rows; r++)
+            {
+                tensor_frequencies[r] =
+                    (float)(remap ? remap->row_frequency[r] : r * config.sample_rate / state.window_size);
+            }
+        }
+        else
+        {
+            message_buffer.resize((size_t)COLS * ROWS * image->bytes_per_pixel);
+        }
+
+        if (auto_gain != "off")
+        {
+            // db_floor and db_ceiling only cover the first column
+            autogain_mode_t mode = auto_gain == "per_bin" ? AUTOGAIN_PER_BIN : AUTOGAIN_GLOBAL;
+            if (auto_gain != "per_bin" && auto_gain != "global")
+            {
+                NST_LOG_WARN("Unknown auto_gain %s, using global\n", auto_gain.c_str());
+            }
+            autogain = autogain_create(mode, rendered_rows, gain_low_quantile, gain_high_quantile,
+                                       gain_min_range_db, db_floor, db_ceiling);
+            if (!autogain)
+            {
+                NST_LOG_ERROR("Could not set up auto gain between quantiles %g and %g\n",
+                              gain_low_quantile, gain_high_quantile);
+                return EXIT_FAILURE;
+            }
+        }
+        NST_LOG_INFO("Window size: %d, hop size: %d\n", state.window_size, state.hop_size);
     }
     const auto onProblem = [](const mcap::Status &status)
     {
@@ -187,7 +459,7 @@ int main(int argc, char *argv[])
     mcap::ReadMessageOptions options;
     auto messageView = reader.readMessages(onProblem, options);
 
-    nst_event_t input_event;
+    nst_event_t input_event = {};
     nst_event_t output_events[4];
     int output_events_count = 0;
 
@@ -245,12 +517,78 @@ int main(int argc, char *argv[])
   }
 }
   )");
-    mcap::Schema compressedImageSchema("foxglove.CompressedImage", "jsonschema", compressedImageSchemaJson.dump());
-    std::cout << "schema:" << compressedImageSchemaJson.dump() << '\n';
-    writer.addSchema(compressedImageSchema);
+    json rawImageSchemaJson = json::parse(R"(
+{
+  "title": "foxglove.RawImage",
+  "description": "A raw image",
+  "$comment": "Generated by https://github.com/foxglove/schemas",
+  "type": "object",
+  "properties": {
+    "timestamp": {
+      "type": "object",
+      "title": "time",
+      "properties": {
+        "sec": {
+          "type": "integer",
+          "minimum": 0
+        },
+        "nsec": {
+          "type": "integer",
+          "minimum": 0,
+          "maximum": 999999999
+        }
+      },
+      "description": "Timestamp of image"
+    },
+    "frame_id": {
+      "type": "string",
+      "description": "Frame of reference for the image. The origin of the frame is the optical center of the camera. +x points to the right in the image, +y points down, and +z points into the plane of the image."
+    },
+    "width": {
+      "type": "integer",
+      "minimum": 0,
+      "description": "Image width"
+    },
+    "height": {
+      "type": "integer",
+      "minimum": 0,
+      "description": "Image height"
+    },
+    "encoding": {
+      "type": "string",
+      "description": "Encoding of the raw image data\n\nSupported values: `8UC1`, `8UC3`, `16UC1`, `32FC1`, `bayer_bggr8`, `bayer_gbrg8`, `bayer_grbg8`, `bayer_rggb8`, `bgr8`, `bgra8`, `mono8`, `mono16`, `rgb8`, `rgba8`, `uyvy` or `UYVY`, `yuyv` or `YUYV`"
+    },
+    "step": {
+      "type": "integer",
+      "minimum": 0,
+      "description": "Byte length of a single row"
+    },
+    "data": {
+      "type": "string",
+      "contentEncoding": "base64",
+      "description": "Raw image data"
+    }
+  }
+}
+  )");
 
-    // Register a Channel
-    outputChannel = mcap::Channel("spectrogram", "json", compressedImageSchema.id);
+    // Register a Schema and Channel for the output mode
+    if (output_mode == OUTPUT_TENSOR)
+    {
+        mcap::Schema tensorSchema("nst.SpectrogramColumn", "nst", std::string(tensor_message_schema));
+        writer.addSchema(tensorSchema);
+        outputChannel = mcap::Channel("spectrogram_tensor", "nst", tensorSchema.id);
+    }
+    else
+    {
+        bool raw = output_mode == OUTPUT_RAW_IMAGE;
+        const json &schemaJson = raw ? rawImageSchemaJson : compressedImageSchemaJson;
+        mcap::Schema imageSchema(raw ? "foxglove.RawImage" : "foxglove.CompressedImage", "jsonschema",
+                                 schemaJson.dump());
+        NST_LOG_DEBUG("schema:%s\n", schemaJson.dump().c_str());
+        writer.addSchema(imageSchema);
+        outputChannel = mcap::Channel("spectrogram", "json", imageSchema.id);
+    }
     writer.addChannel(outputChannel);
 
     for (auto it = messageView.begin(); it != messageView.end(); it++)
@@ -290,6 +628,10 @@ int main(int argc, char *argv[])
         {
             // accelerometer
             id = 1;
+            // Axes the message does not carry read as 0, not as the last
+            // message's values
+            input_event = {};
+            values_count = std::min(values_count, (size_t)NST_EVENT_MAX_VALUES_COUNT);
             for (int i = 0; i < values_count; i++)
             {
                 input_event.id = id;
@@ -299,29 +641,88 @@ int main(int argc, char *argv[])
             }
 
             output_events_count = 0;
-            algorithm_update(&state, &input_event);
-
-            spectrogramToRGB(state.spectrogram, newCol);
+            if (!algorithm_update(&state, &input_event))
+            {
+                // No new column until hop_size samples have arrived
+                continue;
+            }
 
-            // prints out the full newCol as a 2D array
-            for (int i = 0; i < ROWS; i++)
+            const nst_real_t *column = state.spectrogram;
+            if (render_channel < 0 && state.magnitude_spectrogram)
+            {
+                column = state.magnitude_spectrogram;
+            }
+            else if (render_channel > 0 && render_channel < state.channel_count)
             {
-                printf("%d %d %d %d\n", newCol[i][0], newCol[i][1], newCol[i][2], newCol[i][3]);
+                column = state.channel_spectrograms[render_channel];
+            }
+            if (remap)
+            {
+                remap_apply(remap, column, remapped.data());
+                column = remapped.data();
             }
 
-            // prints currentIndex
-            printf("currentIndex: %d\n", currentIndex);
-            updateSlidingWindow(image, newCol, &currentIndex);
+            if (output_mode == OUTPUT_TENSOR && tensor_dtype == TENSOR_FLOAT32)
+            {
+                for (int i = 0; i < rendered_rows; i++)
+                {
+                    tensor_values[i] = (float)column[i];
+                }
+            }
+            else if (autogain)
+            {
+                autogain_quantize(autogain, column, levels.data());
+            }
+            else
+            {
+                // Rows past the last bin stay at level 0
+                decibel_quantize_power(&quantizer, column, rendered_rows, levels.data());
+            }
 
-            // // prints out the full image as a 2D array
-            // for (int i = 0; i < ROWS; i++)
-            // {
-            //     for (int j = 0; j < COLS; j++)
-            //     {
-            //         printf("%d %d ", image[j][i][0], image[j][i][1]);
-            //     }
-            //     printf("\n");
-            // }
+            if (output_mode == OUTPUT_TENSOR)
+            {
+                const void *values = tensor_dtype == TENSOR_FLOAT32 ? (const void *)tensor_values.data()
+                                                                    : (const void *)levels.data();
+                size_t size = tensor_message_write(message_buffer.data(), tensor_dtype, it->message.logTime,
+                                                   rendered_rows, tensor_frequencies.data(), values);
+
+                mcap::Message msg;
+                msg.channelId = outputChannel.id;
+                msg.logTime = it->message.logTime;
+                msg.publishTime = it->message.publishTime;
+                msg.data = reinterpret_cast<const std::byte *>(message_buffer.data());
+                msg.dataSize = size;
+                writer.write(msg);
+                continue;
+            }
+            NST_LOG_DEBUG("Updating sliding window current index: %u\n", image->head);
+            if (image->bytes_per_pixel == 4)
+            {
+                colormap_apply(&colormap, levels.data(), ROWS, newCol.data());
+
+                // Full newCol as a 2D array
+                if (NST_LOG_ENABLED(NST_LOG_LEVEL_TRACE))
+                {
+                    for (int i = 0; i < ROWS; i++)
+                    {
+                        uint8_t r, g, b, a;
+                        colormap_unpack(newCol[i], &r, &g, &b, &a);
+                        nst_log_write("%d %d %d %d\n", r, g, b, a);
+                    }
+                }
+                image_ring_push_column(image, newCol.data());
+            }
+            else
+            {
+                if (NST_LOG_ENABLED(NST_LOG_LEVEL_TRACE))
+                {
+                    for (int i = 0; i < ROWS; i++)
+                    {
+                        nst_log_write("%d\n", levels[i]);
+                    }
+                }
+                image_ring_push_column(image, levels.data());
+            }
 
             json payload;
             payload["id"] = "spectrogram";
@@ -337,25 +738,46 @@ int main(int argc, char *argv[])
             timestamp["nsec"] = nsec;
             payload["timestamp"] = timestamp;
 
-            // Create a dynamic array of numbers and assign it to a field in the JSON object
-            nlohmann::json values = nlohmann::json::array();
-            payload["format"] = "png";
-
-            size_t png_size;
-            unsigned char *png_data = create_png_from_array(&png_size, image, COLS, ROWS, currentIndex);
-
-            // Convert to base64
-            size_t output_length;
-            char *base64_data = base64_encode(png_data, png_size, &output_length);
-            if (!base64_data)
+            const unsigned char *image_data;
+            size_t image_size;
+            if (output_mode == OUTPUT_RAW_IMAGE)
             {
-                perror("Failed to encode base64");
+                size_t step = (size_t)COLS * image->bytes_per_pixel;
+                for (int y = 0; y < ROWS; y++)
+                {
+                    image_ring_copy_row(image, y, message_buffer.data() + y * step);
+                }
+                payload["width"] = COLS;
+                payload["height"] = ROWS;
+                payload["encoding"] = image->bytes_per_pixel == 1 ? "mono8" : "rgba8";
+                payload["step"] = step;
+                image_data = message_buffer.data();
+                image_size = step * ROWS;
+            }
+            else
+            {
+                payload["format"] = "png";
+                image_data = png_encoder_encode_ring(png_encoder, image, &image_size);
+                if (!image_data)
+                {
+                    NST_LOG_ERROR("Failed to encode PNG\n");
+                    continue;
+                }
             }
 
-            printf("Base64 Encoded PNG:\n%s\n", base64_data);
-
-            payload["data"] = base64_data;
+            // The base64 goes straight into the end of the serialized
+            // message, as its characters need no JSON escaping
             std::string serialized = payload.dump();
+            serialized.pop_back(); // closing brace
+            serialized += ",\"data\":\"";
+            size_t data_start = serialized.size();
+            size_t data_length = base64_encoded_length(image_size);
+            serialized.reserve(data_start + data_length + 2);
+            serialized.resize(data_start + data_length);
+            base64_encode_into(image_data, image_size, &serialized[data_start]);
+            serialized += "\"}";
+
+            NST_LOG_TRACE("Base64 encoded image:\n%.*s\n", (int)data_length, serialized.c_str() + data_start);
 
             // Write our message
             mcap::Message msg;
@@ -378,8 +800,11 @@ int main(int argc, char *argv[])
         }
     }
 
-    free(image);
-    free(newCol);
+    free_spectrogram_state(&state);
+    remap_destroy(remap);
+    autogain_destroy(autogain);
+    image_ring_destroy(image);
+    png_encoder_destroy(png_encoder);
     reader.close();
     writer.close();
 
@@ -0,0 +1,58 @@
+#include "tensor_message.h"
+#include <string.h>
+
+const char tensor_message_schema[] =
+    "little-endian, packed\n"
+    "char[4] magic = \"NSTC\"\n"
+    "uint8 version = 1\n"
+    "uint8 dtype # 0 = float32 power, 1 = uint8 level\n"
+    "uint16 rows\n"
+    "int64 timestamp_ns\n"
+    "float32[rows] frequency_hz # row centres, lowest first\n"
+    "dtype[rows] values\n";
+
+int tensor_dtype_from_name(const char *name, tensor_dtype_t *dtype)
+{
+    if (strcmp(name, "float32") == 0)
+    {
+        *dtype = TENSOR_FLOAT32;
+        return 1;
+    }
+    if (strcmp(name, "uint8") == 0)
+    {
+        *dtype = TENSOR_UINT8;
+        return 1;
+    }
+    return 0;
+}
+
+static size_t value_size(tensor_dtype_t dtype)
+{
+    return dtype == TENSOR_FLOAT32 ? sizeof(float) : sizeof(uint8_t);
+}
+
+size_t tensor_message_size(tensor_dtype_t dtype, int rows)
+{
+    if (rows < 1 || rows > TENSOR_MESSAGE_MAX_ROWS)
+        return 0;
+    return TENSOR_MESSAGE_HEADER_SIZE + (size_t)rows * (sizeof(float) + value_size(dtype));
+}
+
+// Fields are copied in host order; every target this builds for is
+// little-endian
+size_t tensor_message_write(unsigned char *out, tensor_dtype_t dtype, int64_t timestamp_ns, int rows,
+                            const float *frequencies, const void *values)
+{
+    uint16_t row_count = (uint16_t)rows;
+    memcpy(out, "NSTC", 4);
+    out[4] = TENSOR_MESSAGE_VERSION;
+    out[5] = (unsigned char)dtype;
+    memcpy(out + 6, &row_count, sizeof(row_count));
+    memcpy(out + 8, &timestamp_ns, sizeof(timestamp_ns));
+
+    size_t offset = TENSOR_MESSAGE_HEADER_SIZE;
+    memcpy(out + offset, frequencies, rows * sizeof(float));
+    offset += rows * sizeof(float);
+    memcpy(out + offset, values, rows * value_size(dtype));
+    return offset + rows * value_size(dtype);
+}
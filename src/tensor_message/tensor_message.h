@@ -0,0 +1,46 @@
+#ifndef TENSOR_MESSAGE_H
+#define TENSOR_MESSAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary spectrogram column for machine consumers, all fields little-endian
+// and packed:
+//
+//   offset  size      field
+//   0       4         magic "NSTC"
+//   4       1         version, TENSOR_MESSAGE_VERSION
+//   5       1         dtype, tensor_dtype_t
+//   6       2         rows, uint16
+//   8       8         timestamp in ns, int64
+//   16      4 * rows  centre frequency of each row in Hz, float32
+//   ...     rows * s  values, float32 power or uint8 level per row
+//
+// Row 0 is the lowest frequency.
+#define TENSOR_MESSAGE_VERSION 1
+#define TENSOR_MESSAGE_HEADER_SIZE 16
+#define TENSOR_MESSAGE_MAX_ROWS 65535
+
+typedef enum
+{
+    TENSOR_FLOAT32,
+    TENSOR_UINT8,
+} tensor_dtype_t;
+
+// "float32" or "uint8". Returns 0 for an unknown name.
+int tensor_dtype_from_name(const char *name, tensor_dtype_t *dtype);
+
+// Bytes in a message of rows values; 0 unless 1 <= rows <=
+// TENSOR_MESSAGE_MAX_ROWS
+size_t tensor_message_size(tensor_dtype_t dtype, int rows);
+
+// Write a message to out, which holds tensor_message_size() bytes, for rows
+// that tensor_message_size() accepts. values are rows floats or bytes per
+// dtype. Returns the bytes written.
+size_t tensor_message_write(unsigned char *out, tensor_dtype_t dtype, int64_t timestamp_ns, int rows,
+                            const float *frequencies, const void *values);
+
+// Schema text stored with the channel
+extern const char tensor_message_schema[];
+
+#endif // TENSOR_MESSAGE_H
@@ -0,0 +1,185 @@
+#include "window.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef struct window_entry
+{
+    struct window_entry *next;
+    window_type_t type;
+    int size;
+    double beta;
+    int refcount;
+    nst_real_t coeffs[];
+} window_entry_t;
+
+// Tables currently in use, shared by type, size and beta. States on
+// different threads acquire and release through the same cache.
+static window_entry_t *window_cache = NULL;
+static pthread_mutex_t window_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const struct
+{
+    const char *name;
+    window_type_t type;
+} window_names[] = {
+    {"rectangular", WINDOW_RECTANGULAR},
+    {"hann", WINDOW_HANN},
+    {"hamming", WINDOW_HAMMING},
+    {"blackman_harris", WINDOW_BLACKMAN_HARRIS},
+    {"flat_top", WINDOW_FLAT_TOP},
+    {"kaiser", WINDOW_KAISER},
+};
+
+int window_type_from_name(const char *name, window_type_t *type)
+{
+    for (size_t i = 0; i < sizeof(window_names) / sizeof(window_names[0]); i++)
+    {
+        if (strcmp(name, window_names[i].name) == 0)
+        {
+            *type = window_names[i].type;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int window_cosine_terms(window_type_t type, double *terms)
+{
+    switch (type)
+    {
+    case WINDOW_RECTANGULAR:
+        terms[0] = 1.0;
+        return 1;
+    case WINDOW_HANN:
+        terms[0] = 0.5;
+        terms[1] = 0.5;
+        return 2;
+    case WINDOW_HAMMING:
+        terms[0] = 0.54;
+        terms[1] = 0.46;
+        return 2;
+    case WINDOW_BLACKMAN_HARRIS:
+        terms[0] = 0.35875;
+        terms[1] = 0.48829;
+        terms[2] = 0.14128;
+        terms[3] = 0.01168;
+        return 4;
+    case WINDOW_FLAT_TOP:
+        terms[0] = 0.21557895;
+        terms[1] = 0.41663158;
+        terms[2] = 0.277263158;
+        terms[3] = 0.083578947;
+        terms[4] = 0.006947368;
+        return 5;
+    default:
+        return 0;
+    }
+}
+
+// Zeroth-order modified Bessel function of the first kind, by its power series
+static double bessel_i0(double x)
+{
+    double term = 1.0;
+    double sum = 1.0;
+    double quarter_x2 = 0.25 * x * x;
+    for (int k = 1; k < 64 && term > 1e-17 * sum; k++)
+    {
+        term *= quarter_x2 / ((double)k * k);
+        sum += term;
+    }
+    return sum;
+}
+
+static void window_fill(window_type_t type, int size, double beta, nst_real_t *w)
+{
+    double terms[WINDOW_MAX_COSINE_TERMS];
+    int count = window_cosine_terms(type, terms);
+
+    if (count > 0)
+    {
+        for (int i = 0; i < size; i++)
+        {
+            double value = 0.0;
+            double sign = 1.0;
+            for (int j = 0; j < count; j++)
+            {
+                value += sign * terms[j] * cos(2 * M_PI * j * i / size);
+                sign = -sign;
+            }
+            w[i] = (nst_real_t)value;
+        }
+        return;
+    }
+
+    // Kaiser: I0(beta * sqrt(1 - t^2)) / I0(beta) with t running over [-1, 1)
+    double scale = 1.0 / bessel_i0(beta);
+    for (int i = 0; i < size; i++)
+    {
+        double t = 2.0 * i / size - 1.0;
+        w[i] = (nst_real_t)(bessel_i0(beta * sqrt(1.0 - t * t)) * scale);
+    }
+}
+
+const nst_real_t *window_acquire(window_type_t type, int size, double beta)
+{
+    if (type == WINDOW_RECTANGULAR || size < 1)
+        return NULL;
+    if (type != WINDOW_KAISER)
+        beta = 0.0;
+
+    pthread_mutex_lock(&window_cache_lock);
+    window_entry_t *entry;
+    for (entry = window_cache; entry; entry = entry->next)
+    {
+        if (entry->type == type && entry->size == size && entry->beta == beta)
+        {
+            entry->refcount++;
+            break;
+        }
+    }
+
+    if (!entry)
+    {
+        entry = (window_entry_t *)malloc(sizeof(window_entry_t) + size * sizeof(nst_real_t));
+        if (entry)
+        {
+            entry->type = type;
+            entry->size = size;
+            entry->beta = beta;
+            entry->refcount = 1;
+            window_fill(type, size, beta, entry->coeffs);
+            entry->next = window_cache;
+            window_cache = entry;
+        }
+    }
+    pthread_mutex_unlock(&window_cache_lock);
+    return entry ? entry->coeffs : NULL;
+}
+
+void window_release(const nst_real_t *table)
+{
+    if (!table)
+        return;
+
+    pthread_mutex_lock(&window_cache_lock);
+    for (window_entry_t **link = &window_cache; *link; link = &(*link)->next)
+    {
+        window_entry_t *entry = *link;
+        if (entry->coeffs == table)
+        {
+            if (--entry->refcount == 0)
+            {
+                *link = entry->next;
+                free(entry);
+            }
+            break;
+        }
+    }
+    pthread_mutex_unlock(&window_cache_lock);
+}
@@ -0,0 +1,36 @@
+#ifndef WINDOW_H
+#define WINDOW_H
+
+#include "../nst_types.h"
+
+// Periodic (DFT-even) analysis windows: w[i] = f(i / size) over one period,
+// so the cosine-sum windows are exact short kernels in the frequency domain.
+typedef enum
+{
+    WINDOW_RECTANGULAR,
+    WINDOW_HANN,
+    WINDOW_HAMMING,
+    WINDOW_BLACKMAN_HARRIS, // 4-term, -92 dB sidelobes
+    WINDOW_FLAT_TOP,        // 5-term, amplitude-accurate peaks
+    WINDOW_KAISER,          // shape set by beta
+} window_type_t;
+
+#define WINDOW_MAX_COSINE_TERMS 5
+
+// Parse "rectangular", "hann", "hamming", "blackman_harris", "flat_top" or
+// "kaiser". Returns 0 for an unknown name.
+int window_type_from_name(const char *name, window_type_t *type);
+
+// Shared coefficient table for a window type and size; states asking for the
+// same window reuse one table. beta is only used by WINDOW_KAISER. Returns
+// NULL for WINDOW_RECTANGULAR or on allocation failure, both of which mean
+// the samples are used unweighted. Release every table that was acquired.
+// Both are thread-safe; tables are read-only once acquired.
+const nst_real_t *window_acquire(window_type_t type, int size, double beta);
+void window_release(const nst_real_t *table);
+
+// Coefficients a_j of a cosine-sum window w[i] = sum_j (-1)^j a_j cos(2*pi*j*i/size).
+// Returns the number of terms, or 0 for windows that are not cosine sums.
+int window_cosine_terms(window_type_t type, double *terms);
+
+#endif // WINDOW_H